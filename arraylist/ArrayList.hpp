@@ -2,132 +2,716 @@
 #define ARRAY_LIST_HPP
 
 #include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <initializer_list>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) && !defined(ARRAY_LIST_NO_SIMD)
+#include <emmintrin.h>
+#define ARRAY_LIST_SSE2
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ARRAY_LIST_AVX2
+#endif
+#endif
+
+// compares a register of elements against another at once. Bit i of the mask
+// from match is set when byte i belongs to an element that compared equal, so
+// a matching element sets sizeof(T) bits. Floating point lanes compare with ==
+// semantics, so NaN never matches and -0.0 matches 0.0. Without SSE2 (or when
+// ARRAY_LIST_NO_SIMD is defined) enabled is false and callers fall back to
+// plain loops; with AVX2 registers are 32 bytes instead of 16.
+template <typename T> struct ArrayListSimd {
+  static constexpr bool enabled = false;
+};
+
+#ifdef ARRAY_LIST_SSE2
+template <typename T>
+  requires(std::is_arithmetic_v<T> && !std::is_same_v<T, bool> &&
+           sizeof(T) <= 8)
+struct ArrayListSimd<T> {
+  static constexpr bool enabled = true;
+
+#ifdef ARRAY_LIST_AVX2
+  using reg = __m256i;
+
+  static reg load(const T *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const reg *>(p));
+  }
+
+  static reg equal(reg a, reg b) {
+    if constexpr (std::is_same_v<T, float>)
+      return _mm256_castps_si256(_mm256_cmp_ps(
+          _mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+    else if constexpr (std::is_same_v<T, double>)
+      return _mm256_castpd_si256(_mm256_cmp_pd(
+          _mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+    else if constexpr (sizeof(T) == 1)
+      return _mm256_cmpeq_epi8(a, b);
+    else if constexpr (sizeof(T) == 2)
+      return _mm256_cmpeq_epi16(a, b);
+    else if constexpr (sizeof(T) == 4)
+      return _mm256_cmpeq_epi32(a, b);
+    else
+      return _mm256_cmpeq_epi64(a, b);
+  }
+
+  static std::uint32_t mask(reg eq) {
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(eq));
+  }
+
+  static reg zero() { return _mm256_setzero_si256(); }
+
+  // byte counters: subtracting an equal() result adds one to every byte of
+  // every element that matched
+  static reg count_bytes(reg counters, reg eq) {
+    return _mm256_sub_epi8(counters, eq);
+  }
+
+  static std::size_t sum_bytes(reg counters) {
+    reg sums = _mm256_sad_epu8(counters, zero());
+    return static_cast<std::size_t>(
+        _mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1) +
+        _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3));
+  }
+#else
+  using reg = __m128i;
+
+  static reg load(const T *p) {
+    return _mm_loadu_si128(reinterpret_cast<const reg *>(p));
+  }
+
+  static reg equal(reg a, reg b) {
+    if constexpr (std::is_same_v<T, float>)
+      return _mm_castps_si128(
+          _mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    else if constexpr (std::is_same_v<T, double>)
+      return _mm_castpd_si128(
+          _mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    else if constexpr (sizeof(T) == 1)
+      return _mm_cmpeq_epi8(a, b);
+    else if constexpr (sizeof(T) == 2)
+      return _mm_cmpeq_epi16(a, b);
+    else if constexpr (sizeof(T) == 4)
+      return _mm_cmpeq_epi32(a, b);
+    else {
+      // SSE2 has no 64 bit compare: both halves have to match
+      reg eq = _mm_cmpeq_epi32(a, b);
+      return _mm_and_si128(eq,
+                           _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+  }
+
+  static std::uint32_t mask(reg eq) {
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(eq));
+  }
+
+  static reg zero() { return _mm_setzero_si128(); }
+
+  // byte counters: subtracting an equal() result adds one to every byte of
+  // every element that matched
+  static reg count_bytes(reg counters, reg eq) {
+    return _mm_sub_epi8(counters, eq);
+  }
+
+  static std::size_t sum_bytes(reg counters) {
+    reg sums = _mm_sad_epu8(counters, zero());
+    return static_cast<std::size_t>(_mm_cvtsi128_si64(sums) +
+                                    _mm_extract_epi16(sums, 4));
+  }
+#endif
+
+  static constexpr std::size_t lanes = sizeof(reg) / sizeof(T);
+
+  static std::uint32_t match(reg a, reg b) { return mask(equal(a, b)); }
+  static constexpr std::uint32_t all = sizeof(reg) == 32 ? ~0U : 0xFFFFU;
+
+  static reg broadcast(T value) {
+    T values[lanes];
+    std::fill_n(values, lanes, value);
+    return load(values);
+  }
+};
+#endif
+
+// the first element in [first, last) equal to value, or last
+template <typename T>
+const T *array_list_find(const T *first, const T *last, const T &value) {
+  if constexpr (ArrayListSimd<T>::enabled) {
+    using simd = ArrayListSimd<T>;
+    auto needle = simd::broadcast(value);
+    for (; static_cast<std::size_t>(last - first) >= simd::lanes;
+         first += simd::lanes) {
+      if (std::uint32_t mask = simd::match(simd::load(first), needle))
+        return first + std::countr_zero(mask) / sizeof(T);
+    }
+  }
+  return std::find(first, last, value);
+}
+
+// the number of elements in [first, last) equal to value
+template <typename T>
+std::size_t array_list_count(const T *first, const T *last, const T &value) {
+  std::size_t ret = 0;
+  if constexpr (ArrayListSimd<T>::enabled) {
+    using simd = ArrayListSimd<T>;
+    auto needle = simd::broadcast(value);
+    while (static_cast<std::size_t>(last - first) >= simd::lanes) {
+      // a byte counter overflows after 255 matches, so they are summed up
+      // at least that often
+      auto counters = simd::zero();
+      for (int i = 0;
+           i < 255 && static_cast<std::size_t>(last - first) >= simd::lanes;
+           ++i, first += simd::lanes) {
+        counters = simd::count_bytes(counters,
+                                     simd::equal(simd::load(first), needle));
+      }
+      ret += simd::sum_bytes(counters) / sizeof(T);
+    }
+  }
+  return ret + static_cast<std::size_t>(std::count(first, last, value));
+}
+
+// whether the n elements at a and b are pairwise equal. Types whose equality
+// is equality of their bytes are compared with memcmp.
+template <typename T> bool array_list_equal(const T *a, const T *b,
+                                            std::size_t n) {
+  if constexpr (std::is_integral_v<T> || std::is_enum_v<T> ||
+                std::is_pointer_v<T>) {
+    return n == 0 || std::memcmp(a, b, n * sizeof(T)) == 0;
+  } else {
+    if constexpr (ArrayListSimd<T>::enabled) {
+      using simd = ArrayListSimd<T>;
+      for (; n >= simd::lanes; n -= simd::lanes, a += simd::lanes,
+                               b += simd::lanes) {
+        if (simd::match(simd::load(a), simd::load(b)) != simd::all)
+          return false;
+      }
+    }
+    return std::equal(a, a + n, b);
+  }
+}
 
 template <typename T> class ArrayListIterator;
 template <typename T> class ArrayListConstIterator;
+template <typename T> class ArrayListConcatView;
+
+// raw memory for N elements kept inside the list itself
+template <typename T, std::size_t N> struct ArrayListInlineBuffer {
+  alignas(T) std::byte bytes[N * sizeof(T)];
+
+  T *get() { return reinterpret_cast<T *>(bytes); }
+  const T *get() const { return reinterpret_cast<const T *>(bytes); }
+};
+
+template <typename T> struct ArrayListInlineBuffer<T, 0> {
+  T *get() const { return nullptr; }
+};
+
+// an ArrayList with InlineN > 0 keeps up to InlineN elements inside the list
+// object and only goes to the heap once it grows past that. Every heap buffer
+// comes from Allocator, which may be stateful such as
+// std::pmr::polymorphic_allocator.
+template <typename T, std::size_t InlineN = 0,
+          typename Allocator = std::allocator<T>>
+class ArrayList {
+  using alloc_traits = std::allocator_traits<Allocator>;
+
+  static constexpr bool nothrow_steal =
+      InlineN == 0 || std::is_nothrow_move_constructible_v<T>;
 
-template <typename T> class ArrayList {
-  std::unique_ptr<T[]> data;
+  [[no_unique_address]] Allocator alloc;
+  [[no_unique_address]] ArrayListInlineBuffer<T, InlineN> inline_buffer;
+
+  // raw storage for _capacity elements, either the inline buffer or the heap.
+  // The _size constructed elements start at _data, which may be past the start
+  // of storage: elements taken off the front leave their slots there, and
+  // appendleft reuses them, so both ends of the list are amortized O(1) while
+  // the elements stay contiguous.
+  T *storage = inline_buffer.get();
+  T *_data = storage;
   std::size_t _size = 0;
+  std::size_t _capacity = InlineN;
+
+  T *allocate(std::size_t n) {
+    return n > 0 ? alloc_traits::allocate(alloc, n) : nullptr;
+  }
+
+  void deallocate(T *p, std::size_t n) {
+    if (p)
+      alloc_traits::deallocate(alloc, p, n);
+  }
+
+  bool is_inline() const { return storage == inline_buffer.get(); }
+
+  // gives storage back to the heap unless it is the inline buffer
+  void release() {
+    if (!is_inline())
+      deallocate(storage, _capacity);
+  }
+
+  std::size_t front_room() const {
+    return static_cast<std::size_t>(_data - storage);
+  }
+
+  std::size_t back_room() const { return _capacity - front_room() - _size; }
+
+  // constructs [first, last) into the raw memory at dest, moving each element
+  // unless its move constructor may throw and it can be copied instead, so
+  // that a throwing relocation leaves the source untouched. Trivially
+  // copyable elements are copied with one memmove; the ranges may overlap.
+  static void relocate(T *first, T *last, T *dest) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      if (first != last)
+        std::memmove(static_cast<void *>(dest), first,
+                     static_cast<std::size_t>(last - first) * sizeof(T));
+    } else {
+      T *out = dest;
+      try {
+        for (; first != last; ++first, ++out)
+          std::construct_at(out, std::move_if_noexcept(*first));
+      } catch (...) {
+        std::destroy(dest, out);
+        throw;
+      }
+    }
+  }
+
+  // moves the elements to start at storage + new_front in a buffer of
+  // new_capacity elements, which is the inline buffer if they fit there. The
+  // elements must be on the heap if they move to the inline buffer.
+  void reallocate(std::size_t new_capacity, std::size_t new_front = 0) {
+    bool to_inline = new_capacity <= InlineN;
+    if (to_inline)
+      new_capacity = InlineN;
+    T *buffer = to_inline ? inline_buffer.get() : allocate(new_capacity);
+    try {
+      relocate(_data, _data + _size, buffer + new_front);
+    } catch (...) {
+      if (!to_inline)
+        deallocate(buffer, new_capacity);
+      throw;
+    }
+    std::destroy(_data, _data + _size);
+    release();
+    storage = buffer;
+    _data = buffer + new_front;
+    _capacity = new_capacity;
+  }
+
+  // moves the elements within the current buffer to start at
+  // storage + new_front
+  void slide_to(std::size_t new_front) {
+    T *dest = storage + new_front;
+    if (dest == _data)
+      return;
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      relocate(_data, _data + _size, dest);
+    } else {
+      // the part of the destination that overlaps the old elements is
+      // assigned to, the rest is raw memory that has to be constructed
+      T *first = _data;
+      T *last = _data + _size;
+      if (dest < first) {
+        std::size_t raw =
+            std::min(_size, static_cast<std::size_t>(first - dest));
+        std::uninitialized_move(first, first + raw, dest);
+        std::move(first + raw, last, dest + raw);
+        std::destroy(std::max(first, dest + _size), last);
+      } else {
+        std::size_t raw =
+            std::min(_size, static_cast<std::size_t>(dest - first));
+        std::uninitialized_move(last - raw, last, dest + _size - raw);
+        std::move_backward(first, last - raw, dest + _size - raw);
+        std::destroy(first, std::min(last, dest));
+      }
+    }
+    _data = dest;
+  }
+
+  // makes room for n more elements after the last one. The slots freed at
+  // the front are reused by sliding the elements down once there are at least
+  // as many of them as elements, which keeps appending after popleft
+  // amortized O(1); otherwise the capacity grows geometrically.
+  void make_room_back(std::size_t n) {
+    if (back_room() >= n)
+      return;
+    if (_size + n <= _capacity && front_room() >= _size)
+      slide_to(0);
+    else
+      reallocate(std::max(_size + n, _capacity * 2));
+  }
+
+  // makes room for n more elements before the first one, leaving half of
+  // the remaining free slots on either side
+  void make_room_front(std::size_t n) {
+    if (front_room() >= n)
+      return;
+    std::size_t free = _capacity - _size;
+    if (free >= n && free - n >= _size) {
+      slide_to(n + (free - n) / 2);
+    } else {
+      std::size_t new_capacity = std::max(_size + n, _capacity * 2);
+      reallocate(new_capacity, n + (new_capacity - _size - n) / 2);
+    }
+  }
+
+  // copy or move constructs the n elements starting at first onto the end.
+  // first must not point into this list.
+  template <typename It> void append_n(It first, std::size_t n) {
+    make_room_back(n);
+    std::uninitialized_copy_n(first, n, _data + _size);
+    _size += n;
+  }
+
+  // inserts the n elements starting at first before index, by shifting
+  // whichever side of index is shorter outwards, or the other side if only
+  // that one has room. first must not point into this list.
+  //
+  // The elements that land in raw memory past the end (or before the front)
+  // are constructed there and the rest are shifted with move_backward (or
+  // move), which is a memmove for trivially copyable T.
+  template <typename It>
+  void insert_n(std::size_t index, It first, std::size_t n) {
+    if (n == 0)
+      return;
+    std::size_t tail = _size - index;
+    bool front = index < tail;
+    if (front ? front_room() < n : back_room() < n)
+      front = front ? back_room() < n : front_room() >= n;
+    if (front) {
+      make_room_front(n);
+      T *old = _data;
+      T *pos = _data + index;
+      if (index > n) {
+        std::uninitialized_move(old, old + n, old - n);
+        _data -= n;
+        _size += n;
+        std::move(old + n, pos, old);
+        std::copy_n(first, n, pos - n);
+      } else {
+        std::uninitialized_copy_n(first, n - index, pos - n);
+        _data = old - (n - index);
+        _size += n - index;
+        std::uninitialized_move(old, pos, old - n);
+        _data = old - n;
+        _size += index;
+        std::copy_n(std::next(first, static_cast<std::ptrdiff_t>(n - index)),
+                    index, old);
+      }
+      return;
+    }
+    make_room_back(n);
+    T *pos = _data + index;
+    T *end = _data + _size;
+    if (tail > n) {
+      std::uninitialized_move(end - n, end, end);
+      _size += n;
+      std::move_backward(pos, end - n, end);
+      std::copy_n(first, n, pos);
+    } else {
+      It rest = std::next(first, static_cast<std::ptrdiff_t>(tail));
+      std::uninitialized_copy_n(rest, n - tail, end);
+      _size += n - tail;
+      std::uninitialized_move(pos, end, pos + n);
+      _size += tail;
+      std::copy_n(first, tail, pos);
+    }
+  }
+
+  // removes the n elements at index by moving whichever side of them is
+  // shorter inwards and destroying the slots left unused at that end. An
+  // emptied list goes back to the start of its buffer.
+  void close_gap(std::size_t index, std::size_t n) {
+    if (index < _size - index - n) {
+      std::move_backward(_data, _data + index, _data + index + n);
+      std::destroy(_data, _data + n);
+      _data += n;
+    } else {
+      std::move(_data + index + n, _data + _size, _data + index);
+      std::destroy(_data + _size - n, _data + _size);
+    }
+    _size -= n;
+    if (_size == 0)
+      _data = storage;
+  }
+
+  // constructs a new element before the first one from args, the mirror of
+  // emplace_back
+  template <typename... Args> void emplace_front(Args &&...args) {
+    if (front_room() == 0) {
+      T value(std::forward<Args>(args)...);
+      make_room_front(1);
+      std::construct_at(_data - 1, std::move(value));
+    } else {
+      std::construct_at(_data - 1, std::forward<Args>(args)...);
+    }
+    --_data;
+    ++_size;
+  }
+
+  // swaps the elements, leaving the allocators where they are
+  void swap_buffers(ArrayList &other) noexcept(nothrow_steal) {
+    if (is_inline() || other.is_inline()) {
+      ArrayList tmp(std::move(other));
+      other.steal(*this);
+      steal(tmp);
+      return;
+    }
+    std::swap(storage, other.storage);
+    std::swap(_data, other._data);
+    std::swap(_size, other._size);
+    std::swap(_capacity, other._capacity);
+  }
+
+  // destroys the elements and gives the buffer back, leaving the list empty
+  // and inline
+  void reset() {
+    std::destroy(_data, _data + _size);
+    release();
+    storage = inline_buffer.get();
+    _data = storage;
+    _size = 0;
+    _capacity = InlineN;
+  }
+
+  // takes over the elements of other, which end up in the inline buffer if
+  // other kept them in its own. This list must be empty and inline, and other
+  // is left that way.
+  void steal(ArrayList &other) {
+    if (other.is_inline()) {
+      relocate(other._data, other._data + other._size, storage);
+      std::destroy(other._data, other._data + other._size);
+      _size = std::exchange(other._size, 0);
+      other._data = other.storage;
+      return;
+    }
+    storage = std::exchange(other.storage, other.inline_buffer.get());
+    _data = std::exchange(other._data, other.storage);
+    _size = std::exchange(other._size, 0);
+    _capacity = std::exchange(other._capacity, InlineN);
+  }
+
+  void check_slice(std::size_t start, std::size_t num_elems) const {
+    if ((start + num_elems) > _size) {
+      throw std::invalid_argument(
+          "cannot get slice of " + std::to_string(num_elems) +
+          " elements starting from index " + std::to_string(start) +
+          " for ArrayList of size " + std::to_string(_size));
+    }
+  }
+
+  void check_insert_index(std::size_t index, const char *what) const {
+    if (index > _size) {
+      throw std::invalid_argument(
+          std::string("cannot insert ") + what + " at index " +
+          std::to_string(index) + " for ArrayList of size " +
+          std::to_string(_size));
+    }
+  }
+
+  // the allocator a copy of this list starts out with
+  Allocator copy_allocator() const {
+    return alloc_traits::select_on_container_copy_construction(alloc);
+  }
 
 public:
+  using allocator_type = Allocator;
+  using iterator = ArrayListIterator<T>;
+  using const_iterator = ArrayListConstIterator<T>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
   ArrayList() = default;
-  ArrayList(std::initializer_list<T> l) {
-    data = std::make_unique<T[]>(l.size());
-    std::copy(l.begin(), l.end(), data.get());
-    _size = l.size();
+
+  explicit ArrayList(const Allocator &a) : alloc(a) {}
+
+  ArrayList(std::initializer_list<T> l, const Allocator &a = Allocator())
+      : alloc(a) {
+    append_n(l.begin(), l.size());
+  }
+
+  ArrayList(const std::string &s, const Allocator &a = Allocator())
+      : alloc(a) {
+    append_n(s.cbegin(), s.size());
+  }
+
+  // moving only hands the buffer over if it is on the heap; inline elements
+  // are moved one by one
+  ArrayList(ArrayList &&other) noexcept(nothrow_steal) : alloc(other.alloc) {
+    steal(other);
   }
 
-  ArrayList(const std::string &s) {
-    data = std::make_unique<T[]>(s.size());
-    std::copy(s.cbegin(), s.cend(), data.get());
-    _size = s.size();
+  ArrayList(const ArrayList &other) : alloc(other.copy_allocator()) {
+    append_n(other._data, other._size);
   }
 
-  ArrayList(ArrayList &&other) {
-    data = std::move(other.data);
-    _size = other._size;
-    other._size = 0;
+  ArrayList(const ArrayList &other, const Allocator &a) : alloc(a) {
+    append_n(other._data, other._size);
   }
 
-  ArrayList(const ArrayList &other) {
-    data = std::make_unique<T[]>(other._size);
-    T *tmp = other.data.get();
-    std::copy(tmp, tmp + other._size, data.get());
-    _size = other._size;
+  ~ArrayList() {
+    std::destroy(_data, _data + _size);
+    release();
   }
 
+  // the copy keeps this list's allocator unless Allocator says to take
+  // other's
   ArrayList &operator=(const ArrayList &other) {
-    ArrayList tmp(other);
-    data = std::move(tmp.data);
-    _size = tmp._size;
+    if (&other == this)
+      return *this;
+    if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+      // the old buffer has to go back to the old allocator first
+      if (alloc != other.alloc)
+        reset();
+      alloc = other.alloc;
+    }
+    ArrayList tmp(other, alloc);
+    swap_buffers(tmp);
     return *this;
   }
 
-  ArrayList &operator=(ArrayList &&other) {
-    data = std::move(other.data);
-    _size = other._size;
-    other._size = 0;
+  // takes other's buffer if the allocators are equal or Allocator says to
+  // take other's. Otherwise the elements are moved one by one into memory
+  // from this list's allocator.
+  ArrayList &operator=(ArrayList &&other) noexcept(
+      nothrow_steal &&
+      (alloc_traits::propagate_on_container_move_assignment::value ||
+       alloc_traits::is_always_equal::value)) {
+    if (&other == this)
+      return *this;
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+      reset();
+      alloc = other.alloc;
+      steal(other);
+    } else if (alloc == other.alloc) {
+      reset();
+      steal(other);
+    } else {
+      ArrayList tmp(alloc);
+      tmp.append_n(std::make_move_iterator(other._data), other._size);
+      other.close_gap(0, other._size);
+      swap_buffers(tmp);
+    }
     return *this;
   }
 
+  // as with the standard containers, lists whose allocators neither compare
+  // equal nor propagate on swap cannot be swapped
+  void swap(ArrayList &other) noexcept(nothrow_steal) {
+    swap_buffers(other);
+    if constexpr (alloc_traits::propagate_on_container_swap::value)
+      std::swap(alloc, other.alloc);
+  }
+
+  Allocator get_allocator() const { return alloc; }
+
   friend std::ostream &operator<<(std::ostream &out, const ArrayList &al) {
     out << "[ ";
     for (std::size_t i = 0; i < al._size; ++i) {
-      out << al.data[i] << ' ';
+      out << al._data[i] << ' ';
     }
     out << "]";
     return out;
   }
 
   bool operator==(const ArrayList &other) const {
-    if (_size != other._size)
-      return false;
-    for (std::size_t i = 0; i < _size; ++i) {
-      if (other.data[i] != data[i])
-        return false;
-    }
-    return true;
+    return _size == other._size && array_list_equal(_data, other._data, _size);
   }
 
-  T &operator[](std::size_t idx) { return data[idx]; }
+  T &operator[](std::size_t idx) { return _data[idx]; }
+  const T &operator[](std::size_t idx) const { return _data[idx]; }
 
-  ArrayList operator+(const ArrayList &other) const {
-    ArrayList ret;
-    ret.data = std::make_unique<T[]>(other._size + _size);
-    ret._size = _size + other._size;
-    std::copy(begin(), end(), ret.data.get());
-    std::copy(other.begin(), other.end(), ret.data.get() + _size);
+  ArrayList operator+(const ArrayList &other) const & {
+    ArrayList ret(copy_allocator());
+    ret.reserve(_size + other._size);
+    ret.append_n(_data, _size);
+    ret.append_n(other._data, other._size);
+    return ret;
+  }
+
+  // a temporary on the left hands its buffer on instead of being copied
+  ArrayList operator+(const ArrayList &other) && {
+    if (&other == this)
+      return std::as_const(*this) + other;
+    ArrayList ret(std::move(*this));
+    ret += other;
     return ret;
   }
 
   ArrayList &operator+=(const ArrayList &other) {
-    std::unique_ptr<T[]> new_data = std::make_unique<T[]>(other._size + _size);
-    std::copy(begin(), end(), new_data.get());
-    std::copy(other.begin(), other.end(), new_data.get() + _size);
-    data = std::move(new_data);
-    _size += other._size;
+    if (&other == this) {
+      ArrayList copy(other);
+      return *this += std::move(copy);
+    }
+    append_n(other._data, other._size);
     return *this;
   }
 
-  bool contains(const T &item) const {
-    return std::find(begin(), end(), item) != end();
+  // moves the elements of other over, leaving other empty
+  ArrayList &operator+=(ArrayList &&other) {
+    if (&other == this)
+      return *this += std::as_const(other);
+    append_n(std::make_move_iterator(other._data), other._size);
+    other.close_gap(0, other._size);
+    return *this;
   }
 
+  bool contains(const T &item) const { return find(item) != end(); }
+
+  // the first element equal to item, or end()
+  iterator find(const T &item) {
+    return const_cast<T *>(array_list_find<T>(_data, _data + _size, item));
+  }
+
+  const_iterator find(const T &item) const {
+    return array_list_find<T>(_data, _data + _size, item);
+  }
+
+  // the number of elements equal to item
+  std::size_t count(const T &item) const {
+    return array_list_count<T>(_data, _data + _size, item);
+  }
+
+  // inserts item before index, or at the end if index is the size
   void insert(std::size_t index, const T &item) {
-    if (index >= _size) {
-      throw std::invalid_argument(
-          "cannot insert item at index " + std::to_string(index) +
-          " for ArrayList of size " + std::to_string(_size));
-    }
-    std::unique_ptr<T[]> tmp = std::make_unique<T[]>(_size + 1);
-    std::copy(data.get(), data.get() + index, tmp.get());
-    tmp[index] = item;
-    std::copy(data.get() + index, data.get() + _size, tmp.get() + index + 1);
-    data = std::move(tmp);
-    _size++;
+    check_insert_index(index, "item");
+    // copied first, since item may be an element that is about to move
+    T value(item);
+    insert_n(index, std::make_move_iterator(&value), 1);
+  }
+
+  void insert(std::size_t index, T &&item) {
+    check_insert_index(index, "item");
+    T value(std::move(item));
+    insert_n(index, std::make_move_iterator(&value), 1);
   }
 
   void insert(std::size_t index, const ArrayList &items) {
-    if (index >= _size) {
-      throw std::invalid_argument(
-          "cannot insert items at index " + std::to_string(index) +
-          " for ArrayList of size " + std::to_string(_size));
-    }
-    if (items.empty())
+    check_insert_index(index, "items");
+    if (&items == this) {
+      ArrayList copy(items);
+      insert(index, std::move(copy));
       return;
-    std::unique_ptr<T[]> tmp = std::make_unique<T[]>(_size + items._size);
-    std::copy(data.get(), data.get() + index, tmp.get());
-    std::copy(items.begin(), items.end(), tmp.get() + index);
-    std::copy(data.get() + index, data.get() + _size,
-              tmp.get() + index + items._size);
-    data = std::move(tmp);
-    _size += items._size;
+    }
+    insert_n(index, items._data, items._size);
+  }
+
+  void insert(std::size_t index, ArrayList &&items) {
+    check_insert_index(index, "items");
+    insert_n(index, std::make_move_iterator(items._data), items._size);
+    items.close_gap(0, items._size);
   }
 
   void remove(std::size_t index) {
@@ -136,11 +720,7 @@ public:
           "cannot remove element at index " + std::to_string(index) +
           " for ArrayList of size " + std::to_string(_size));
     }
-    std::unique_ptr<T[]> tmp = std::make_unique<T[]>(_size - 1);
-    std::copy(data.get(), data.get() + index, tmp.get());
-    std::copy(data.get() + index + 1, data.get() + _size, tmp.get() + index);
-    data = std::move(tmp);
-    _size--;
+    close_gap(index, 1);
   }
 
   void remove(std::size_t start, std::size_t num_elems) {
@@ -150,136 +730,395 @@ public:
           " elements starting from index " + std::to_string(start) +
           " for ArrayList of size " + std::to_string(_size));
     }
-    std::unique_ptr<T[]> tmp = std::make_unique<T[]>(_size - num_elems);
-    std::copy(data.get(), data.get() + start, tmp.get());
-    std::copy(data.get() + start + num_elems, data.get() + _size,
-              tmp.get() + start);
-    data = std::move(tmp);
-    _size -= num_elems;
+    close_gap(start, num_elems);
   }
 
   bool empty() const { return _size == 0; }
 
   ArrayList slice(std::size_t start, std::size_t num_elems) {
-    if ((start + num_elems) > _size) {
-      throw std::invalid_argument(
-          "cannot get slice of " + std::to_string(num_elems) +
-          " elements starting from index " + std::to_string(start) +
-          " for ArrayList of size " + std::to_string(_size));
-    }
-    ArrayList ret;
-    ret.data = std::make_unique<T[]>(num_elems);
-    std::copy(data.get() + start, data.get() + start + num_elems,
-              ret.data.get());
-    ret._size = num_elems;
+    check_slice(start, num_elems);
+    ArrayList ret(copy_allocator());
+    ret.append_n(_data + start, num_elems);
     return ret;
   }
 
-  std::size_t size() { return _size; }
+  // like slice, but refers to the elements in this list instead of copying
+  // them. The view is invalidated by anything that invalidates iterators.
+  std::span<T> slice_view(std::size_t start, std::size_t num_elems) {
+    check_slice(start, num_elems);
+    return {_data + start, num_elems};
+  }
 
-  void append(const T &val) { *this += {val}; }
+  std::span<const T> slice_view(std::size_t start,
+                                std::size_t num_elems) const {
+    check_slice(start, num_elems);
+    return {_data + start, num_elems};
+  }
 
-  void appendleft(const T &val) { insert(0, val); }
+  // a view of the elements of this list followed by those of other, which
+  // reads through to both instead of copying them like operator+
+  ArrayListConcatView<T> concat_view(std::span<T> other) {
+    return ArrayListConcatView<T>(*this).concat_view(other);
+  }
+
+  ArrayListConcatView<const T> concat_view(std::span<const T> other) const {
+    return ArrayListConcatView<const T>(*this).concat_view(other);
+  }
+
+  std::size_t size() const { return _size; }
+
+  std::size_t capacity() const { return _capacity; }
+
+  // grows the list to n elements by appending value-initialized ones, or
+  // shrinks it to its first n elements
+  void resize(std::size_t n) {
+    if (n <= _size) {
+      close_gap(n, _size - n);
+      return;
+    }
+    make_room_back(n - _size);
+    std::uninitialized_value_construct(_data + _size, _data + n);
+    _size = n;
+  }
+
+  // the same, appending copies of value
+  void resize(std::size_t n, const T &value) {
+    if (n <= _size) {
+      close_gap(n, _size - n);
+      return;
+    }
+    // copied first, since value may be an element that is about to move
+    T copy(value);
+    make_room_back(n - _size);
+    std::uninitialized_fill(_data + _size, _data + n, copy);
+    _size = n;
+  }
+
+  // makes room for at least n elements, so that appending up to n elements
+  // does not reallocate
+  void reserve(std::size_t n) {
+    if (n > _capacity)
+      reallocate(n);
+    else if (n > _capacity - front_room())
+      slide_to(0);
+  }
+
+  // gives back any capacity beyond the current size, moving the elements
+  // back into the inline buffer if they fit
+  void shrink_to_fit() {
+    if (_capacity > std::max(_size, InlineN))
+      reallocate(_size);
+  }
+
+  // constructs a new element at the end from args and returns it
+  template <typename... Args> T &emplace_back(Args &&...args) {
+    if (back_room() == 0) {
+      // built before making room, since args may refer to an element that is
+      // about to move
+      T value(std::forward<Args>(args)...);
+      make_room_back(1);
+      std::construct_at(_data + _size, std::move(value));
+    } else {
+      std::construct_at(_data + _size, std::forward<Args>(args)...);
+    }
+    return _data[_size++];
+  }
+
+  void append(const T &val) { emplace_back(val); }
+
+  void append(T &&val) { emplace_back(std::move(val)); }
+
+  void appendleft(const T &val) { emplace_front(val); }
+
+  void appendleft(T &&val) { emplace_front(std::move(val)); }
 
   T pop() {
     if (empty()) {
       throw std::runtime_error("cannot pop from empty list");
     }
-    return data[--_size];
+    T ret = std::move(_data[_size - 1]);
+    close_gap(_size - 1, 1);
+    return ret;
   }
 
   T popleft() {
     if (empty()) {
       throw std::runtime_error("cannot pop from empty list");
     }
-    T ret = data[0];
-    std::unique_ptr<T[]> tmp = std::make_unique<T[]>(_size - 1);
-    std::copy(data.get() + 1, data.get() + _size, tmp.get());
-    _size--;
-    data = std::move(tmp);
+    T ret = std::move(_data[0]);
+    close_gap(0, 1);
     return ret;
   }
 
-  ArrayListIterator<T> begin() { return {data.get(), 0}; }
-  ArrayListConstIterator<T> begin() const { return {data.get(), 0}; }
+  // the elements are contiguous, so data() to data() + size() is a plain
+  // array of them
+  T *data() { return _data; }
+  const T *data() const { return _data; }
+
+  iterator begin() { return _data; }
+  const_iterator begin() const { return _data; }
 
-  ArrayListIterator<T> end() { return {data.get(), _size}; }
-  ArrayListConstIterator<T> end() const { return {data.get(), _size}; }
+  iterator end() { return _data + _size; }
+  const_iterator end() const { return _data + _size; }
 
-  ArrayListConstIterator<T> cbegin() const { return {data.get(), 0}; }
-  ArrayListConstIterator<T> cend() const { return {data.get(), _size}; }
+  const_iterator cbegin() const { return _data; }
+  const_iterator cend() const { return _data + _size; }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  const_reverse_iterator crbegin() const { return rbegin(); }
+  const_reverse_iterator crend() const { return rend(); }
 };
 
 template <typename T> class ArrayListIterator {
-  T *data;
-  std::size_t idx;
+  T *ptr = nullptr;
 
 public:
-  using iterator_category = std::bidirectional_iterator_tag;
-  using value_type = T;
+  using iterator_concept = std::contiguous_iterator_tag;
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::remove_cv_t<T>;
+  using element_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T *;
+  using reference = T &;
+
+  ArrayListIterator() = default;
 
-  ArrayListIterator(T *_data, std::size_t _idx) : data(_data), idx(_idx) {}
+  ArrayListIterator(T *_ptr) : ptr(_ptr) {}
 
   ArrayListIterator &operator++() {
-    idx++;
+    ++ptr;
     return *this;
   }
 
-  ArrayListIterator operator++(int) { return {data, idx++}; }
+  ArrayListIterator operator++(int) { return ptr++; }
 
   ArrayListIterator &operator--() {
-    idx--;
+    --ptr;
     return *this;
   }
 
-  ArrayListIterator operator--(int) { return {data, idx--}; }
+  ArrayListIterator operator--(int) { return ptr--; }
+
+  ArrayListIterator &operator+=(difference_type n) {
+    ptr += n;
+    return *this;
+  }
+
+  ArrayListIterator &operator-=(difference_type n) {
+    ptr -= n;
+    return *this;
+  }
+
+  friend ArrayListIterator operator+(ArrayListIterator it, difference_type n) {
+    return it += n;
+  }
+
+  friend ArrayListIterator operator+(difference_type n, ArrayListIterator it) {
+    return it += n;
+  }
+
+  friend ArrayListIterator operator-(ArrayListIterator it, difference_type n) {
+    return it -= n;
+  }
+
+  difference_type operator-(const ArrayListIterator &other) const {
+    return ptr - other.ptr;
+  }
 
   bool operator==(const ArrayListIterator &other) const {
-    return other.idx == idx;
+    return ptr == other.ptr;
   }
 
-  bool operator!=(const ArrayListIterator &other) const {
-    return !(*this == other);
+  auto operator<=>(const ArrayListIterator &other) const {
+    return ptr <=> other.ptr;
   }
 
-  value_type &operator*() { return data[idx]; }
+  reference operator*() const { return *ptr; }
 
-  const value_type &operator*() const { return data[idx]; }
+  pointer operator->() const { return ptr; }
+
+  reference operator[](difference_type n) const { return ptr[n]; }
 };
 
 template <typename T> class ArrayListConstIterator {
-  T *data;
-  std::size_t idx;
+  const T *ptr = nullptr;
 
 public:
-  using iterator_category = std::bidirectional_iterator_tag;
-  using value_type = T;
+  using iterator_concept = std::contiguous_iterator_tag;
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::remove_cv_t<T>;
+  using element_type = const T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const T *;
+  using reference = const T &;
+
+  ArrayListConstIterator() = default;
 
-  ArrayListConstIterator(T *_data, std::size_t _idx) : data(_data), idx(_idx) {}
+  ArrayListConstIterator(const T *_ptr) : ptr(_ptr) {}
+
+  // every iterator converts to the const iterator at the same position
+  ArrayListConstIterator(ArrayListIterator<T> it) : ptr(it.operator->()) {}
 
   ArrayListConstIterator &operator++() {
-    idx++;
+    ++ptr;
     return *this;
   }
 
-  ArrayListConstIterator operator++(int) { return {data, idx++}; }
+  ArrayListConstIterator operator++(int) { return ptr++; }
 
   ArrayListConstIterator &operator--() {
-    idx--;
+    --ptr;
+    return *this;
+  }
+
+  ArrayListConstIterator operator--(int) { return ptr--; }
+
+  ArrayListConstIterator &operator+=(difference_type n) {
+    ptr += n;
+    return *this;
+  }
+
+  ArrayListConstIterator &operator-=(difference_type n) {
+    ptr -= n;
     return *this;
   }
 
-  ArrayListConstIterator operator--(int) { return {data, idx--}; }
+  friend ArrayListConstIterator operator+(ArrayListConstIterator it,
+                                          difference_type n) {
+    return it += n;
+  }
+
+  friend ArrayListConstIterator operator+(difference_type n,
+                                          ArrayListConstIterator it) {
+    return it += n;
+  }
+
+  friend ArrayListConstIterator operator-(ArrayListConstIterator it,
+                                          difference_type n) {
+    return it -= n;
+  }
+
+  difference_type operator-(const ArrayListConstIterator &other) const {
+    return ptr - other.ptr;
+  }
 
   bool operator==(const ArrayListConstIterator &other) const {
-    return other.idx == idx;
+    return ptr == other.ptr;
+  }
+
+  auto operator<=>(const ArrayListConstIterator &other) const {
+    return ptr <=> other.ptr;
+  }
+
+  reference operator*() const { return *ptr; }
+
+  pointer operator->() const { return ptr; }
+
+  reference operator[](difference_type n) const { return ptr[n]; }
+};
+
+// an ArrayList for lists that are usually short, which then never allocate
+template <typename T, std::size_t N = 8,
+          typename Allocator = std::allocator<T>>
+using SmallArrayList = ArrayList<T, N, Allocator>;
+
+// a read through view of several contiguous ranges one after the other, such
+// as ArrayLists, slice views or spans. T is const for a read only view. The
+// ranges are referred to, never copied, and up to four of them are kept
+// without allocating.
+template <typename T> class ArrayListConcatView {
+  SmallArrayList<std::span<T>, 4> parts;
+  std::size_t _size = 0;
+
+public:
+  class iterator {
+    const ArrayListConcatView *view = nullptr;
+    std::size_t part = 0;
+    std::size_t offset = 0;
+
+    // steps over empty parts so that offset is always inside part
+    void skip_empty() {
+      while (part < view->parts.size() && offset == view->parts[part].size()) {
+        ++part;
+        offset = 0;
+      }
+    }
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::remove_cv_t<T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using reference = T &;
+
+    iterator() = default;
+
+    iterator(const ArrayListConcatView *_view, std::size_t _part)
+        : view(_view), part(_part) {
+      skip_empty();
+    }
+
+    iterator &operator++() {
+      ++offset;
+      skip_empty();
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator ret = *this;
+      ++*this;
+      return ret;
+    }
+
+    bool operator==(const iterator &other) const {
+      return part == other.part && offset == other.offset;
+    }
+
+    reference operator*() const { return view->parts[part][offset]; }
+
+    pointer operator->() const { return &**this; }
+  };
+
+  ArrayListConcatView() = default;
+
+  explicit ArrayListConcatView(std::span<T> first) { concat(first); }
+
+  // appends the elements of next to this view
+  void concat(std::span<T> next) {
+    parts.append(next);
+    _size += next.size();
+  }
+
+  // a copy of this view followed by next, so views can be chained
+  ArrayListConcatView concat_view(std::span<T> next) const {
+    ArrayListConcatView ret(*this);
+    ret.concat(next);
+    return ret;
   }
 
-  bool operator!=(const ArrayListConstIterator &other) const {
-    return !(*this == other);
+  std::size_t size() const { return _size; }
+
+  bool empty() const { return _size == 0; }
+
+  // the element at idx, found by walking over the parts
+  T &operator[](std::size_t idx) const {
+    std::size_t part = 0;
+    while (idx >= parts[part].size())
+      idx -= parts[part++].size();
+    return parts[part][idx];
   }
 
-  const value_type &operator*() const { return data[idx]; }
+  iterator begin() const { return {this, 0}; }
+  iterator end() const { return {this, parts.size()}; }
 };
 
 #endif // !ARRAY_LIST_HPP
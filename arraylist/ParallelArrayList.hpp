@@ -0,0 +1,309 @@
+#ifndef PARALLEL_ARRAY_LIST_HPP
+#define PARALLEL_ARRAY_LIST_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ArrayList.hpp"
+
+// lists shorter than this are never split up, since handing a chunk to
+// another thread costs more than working through it
+#define PARALLEL_MIN_CHUNK 4096
+
+// chunks handed out per thread, so that a thread that finishes early has
+// something left to steal
+#define PARALLEL_CHUNKS_PER_THREAD 4
+
+// a small work stealing thread pool. Every thread has its own queue of tasks,
+// which it works through from the back, and takes tasks from the front of the
+// other queues once its own is empty. The thread that calls run counts as one
+// of the pool's threads: it works on the tasks it handed out instead of
+// waiting for them, so a pool of one thread starts no threads at all and
+// nested calls from inside a task do not deadlock.
+class ThreadPool {
+  struct alignas(64) task_queue {
+    std::mutex lock;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  std::size_t _concurrency;
+  // queue 0 belongs to whoever calls run from outside the pool
+  std::unique_ptr<task_queue[]> queues;
+  std::vector<std::thread> threads;
+
+  std::mutex sleep_lock;
+  std::condition_variable wake;
+  std::atomic<std::size_t> queued{0};
+  bool stopping = false;
+
+  // the pool and queue of the current thread if it is one of a pool's
+  static inline thread_local ThreadPool *current_pool = nullptr;
+  static inline thread_local std::size_t current_queue = 0;
+
+  std::size_t own_queue() const {
+    return current_pool == this ? current_queue : 0;
+  }
+
+  // runs one task, from the back of queue self or else stolen from the front
+  // of another, and returns whether there was one
+  bool run_one(std::size_t self) {
+    std::function<void()> task;
+    {
+      std::lock_guard guard(queues[self].lock);
+      if (!queues[self].tasks.empty()) {
+        task = std::move(queues[self].tasks.back());
+        queues[self].tasks.pop_back();
+      }
+    }
+    for (std::size_t i = 1; !task && i < _concurrency; ++i) {
+      task_queue &victim = queues[(self + i) % _concurrency];
+      std::lock_guard guard(victim.lock);
+      if (!victim.tasks.empty()) {
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+      }
+    }
+    if (!task)
+      return false;
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    task();
+    return true;
+  }
+
+  void work(std::size_t self) {
+    current_pool = this;
+    current_queue = self;
+    while (true) {
+      if (run_one(self))
+        continue;
+      std::unique_lock guard(sleep_lock);
+      wake.wait(guard, [this] {
+        return stopping || queued.load(std::memory_order_relaxed) > 0;
+      });
+      if (stopping)
+        return;
+    }
+  }
+
+public:
+  // a pool of n threads, counting the one that calls run
+  explicit ThreadPool(
+      std::size_t n = std::max(1U, std::thread::hardware_concurrency()))
+      : _concurrency(std::max<std::size_t>(n, 1)),
+        queues(std::make_unique<task_queue[]>(_concurrency)) {
+    for (std::size_t i = 1; i < _concurrency; ++i)
+      threads.emplace_back([this, i] { work(i); });
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard guard(sleep_lock);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &thread : threads)
+      thread.join();
+  }
+
+  std::size_t concurrency() const { return _concurrency; }
+
+  // calls f(i) for every i below n spread over the pool, and returns once all
+  // of them have. The first exception thrown by any of them is rethrown here
+  // after the rest have finished.
+  template <typename F> void run(std::size_t n, F f) {
+    if (n == 0)
+      return;
+    std::size_t self = own_queue();
+    std::atomic<std::size_t> remaining{n};
+    std::exception_ptr error;
+    std::mutex error_lock;
+    auto task = [&](std::size_t i) {
+      try {
+        f(i);
+      } catch (...) {
+        std::lock_guard guard(error_lock);
+        if (!error)
+          error = std::current_exception();
+      }
+      remaining.fetch_sub(1, std::memory_order_acq_rel);
+    };
+    // task i goes to queue i % concurrency, the caller's share to its own
+    for (std::size_t q = 0; q < _concurrency; ++q) {
+      task_queue &queue = queues[(self + q) % _concurrency];
+      std::lock_guard guard(queue.lock);
+      for (std::size_t i = q; i < n; i += _concurrency)
+        queue.tasks.emplace_back([&task, i] { task(i); });
+    }
+    queued.fetch_add(n, std::memory_order_relaxed);
+    {
+      std::lock_guard guard(sleep_lock);
+    }
+    wake.notify_all();
+    while (remaining.load(std::memory_order_acquire) > 0) {
+      if (!run_one(self))
+        std::this_thread::yield();
+    }
+    if (error)
+      std::rethrow_exception(error);
+  }
+};
+
+// the pool the parallel_ functions use unless given one, with a thread per
+// hardware thread
+inline ThreadPool &default_thread_pool() {
+  static ThreadPool pool;
+  return pool;
+}
+
+// calls f(begin, end, i) on consecutive chunks [begin, end) covering [0, n)
+// spread over pool, where i numbers the chunks from 0, and returns the number
+// of chunks. There are at most concurrency() * PARALLEL_CHUNKS_PER_THREAD.
+template <typename F>
+std::size_t parallel_chunks(ThreadPool &pool, std::size_t n, F f) {
+  std::size_t chunks = std::min(
+      std::max<std::size_t>(n / PARALLEL_MIN_CHUNK, 1),
+      pool.concurrency() * PARALLEL_CHUNKS_PER_THREAD);
+  if (chunks == 1) {
+    f(std::size_t{0}, n, std::size_t{0});
+    return 1;
+  }
+  pool.run(chunks,
+           [&](std::size_t i) { f(i * n / chunks, (i + 1) * n / chunks, i); });
+  return chunks;
+}
+
+// a list of f(x) for every element x of list, in the same order. The results
+// are written in place, so they have to be default constructible.
+template <typename T, std::size_t N, typename Allocator, typename F>
+auto parallel_map(const ArrayList<T, N, Allocator> &list, F f,
+                  ThreadPool &pool = default_thread_pool()) {
+  using U = std::remove_cvref_t<std::invoke_result_t<F &, const T &>>;
+  ArrayList<U> ret;
+  ret.resize(list.size());
+  const T *in = list.data();
+  U *out = ret.data();
+  parallel_chunks(pool, list.size(),
+                  [&](std::size_t begin, std::size_t end, std::size_t) {
+                    for (std::size_t i = begin; i < end; ++i)
+                      out[i] = f(in[i]);
+                  });
+  return ret;
+}
+
+// a list of the elements x of list for which pred(x) holds, in their
+// original order. Every chunk first counts the elements it keeps, an
+// exclusive prefix sum over the counts gives each chunk the position its
+// elements start at in the result, and then the chunks copy their elements
+// there independently.
+template <typename T, std::size_t N, typename Allocator, typename Pred>
+ArrayList<T> parallel_filter(const ArrayList<T, N, Allocator> &list,
+                             Pred pred,
+                             ThreadPool &pool = default_thread_pool()) {
+  std::size_t n = list.size();
+  const T *in = list.data();
+  // pred runs once per element, its results are kept for the copy
+  std::unique_ptr<bool[]> keep(new bool[n]);
+  std::vector<std::size_t> offsets(
+      pool.concurrency() * PARALLEL_CHUNKS_PER_THREAD + 1);
+  std::size_t chunks = parallel_chunks(
+      pool, n, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        std::size_t kept = 0;
+        for (std::size_t i = begin; i < end; ++i) {
+          keep[i] = static_cast<bool>(pred(in[i]));
+          kept += keep[i];
+        }
+        offsets[chunk + 1] = kept;
+      });
+  for (std::size_t i = 1; i <= chunks; ++i)
+    offsets[i] += offsets[i - 1];
+
+  ArrayList<T> ret;
+  ret.resize(offsets[chunks]);
+  T *out = ret.data();
+  parallel_chunks(pool, n,
+                  [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+                    T *dest = out + offsets[chunk];
+                    for (std::size_t i = begin; i < end; ++i) {
+                      if (keep[i])
+                        *dest++ = in[i];
+                    }
+                  });
+  return ret;
+}
+
+// init combined with every element of list by op, which has to be
+// associative and, as for std::reduce, the elements have to convert to R.
+// Chunks are reduced in parallel and their results combined from left to
+// right, so op does not have to be commutative.
+template <typename T, std::size_t N, typename Allocator, typename R,
+          typename Op = std::plus<>>
+R parallel_reduce(const ArrayList<T, N, Allocator> &list, R init, Op op = {},
+                  ThreadPool &pool = default_thread_pool()) {
+  const T *in = list.data();
+  std::vector<std::optional<R>> partial(pool.concurrency() *
+                                        PARALLEL_CHUNKS_PER_THREAD);
+  std::size_t chunks = parallel_chunks(
+      pool, list.size(),
+      [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        if (begin == end)
+          return;
+        R acc = static_cast<R>(in[begin]);
+        for (std::size_t i = begin + 1; i < end; ++i)
+          acc = op(std::move(acc), in[i]);
+        partial[chunk] = std::move(acc);
+      });
+  for (std::size_t i = 0; i < chunks; ++i) {
+    if (partial[i])
+      init = op(std::move(init), std::move(*partial[i]));
+  }
+  return init;
+}
+
+// sorts list by comp. Chunks are sorted in parallel, then merged pairwise in
+// rounds, each round's merges running in parallel, until one run is left.
+template <typename T, std::size_t N, typename Allocator,
+          typename Compare = std::less<>>
+void parallel_sort(ArrayList<T, N, Allocator> &list, Compare comp = {},
+                   ThreadPool &pool = default_thread_pool()) {
+  std::size_t n = list.size();
+  T *data = list.data();
+  std::vector<std::size_t> bounds{0};
+  std::size_t chunks = parallel_chunks(
+      pool, n, [&](std::size_t begin, std::size_t end, std::size_t) {
+        std::sort(data + begin, data + end, comp);
+      });
+  for (std::size_t i = 1; i <= chunks; ++i)
+    bounds.push_back(i * n / chunks);
+
+  while (bounds.size() > 2) {
+    std::size_t runs = bounds.size() - 1;
+    pool.run(runs / 2, [&](std::size_t pair) {
+      std::size_t first = bounds[2 * pair];
+      std::inplace_merge(data + first, data + bounds[2 * pair + 1],
+                         data + bounds[2 * pair + 2], comp);
+    });
+    std::vector<std::size_t> merged;
+    for (std::size_t i = 0; i < bounds.size(); i += 2)
+      merged.push_back(bounds[i]);
+    if (runs % 2 == 1)
+      merged.push_back(bounds.back());
+    bounds = std::move(merged);
+  }
+}
+
+#endif // !PARALLEL_ARRAY_LIST_HPP
@@ -0,0 +1,123 @@
+#include "ArrayList.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <execution>
+#include <numeric>
+#include <random>
+#include <vector>
+
+/**
+ * Runs std::sort and std::reduce with std::execution::par_unseq over an
+ * ArrayList, a std::vector, and an ArrayList walked through an index based
+ * iterator like the one ArrayList used to have, which stores the base pointer
+ * and an index and does not model std::contiguous_iterator. Reports the time
+ * for each.
+ *
+ * usage: ./bench_algorithms [n, default 10000000] [reduce repetitions,
+ *        default 20]
+ */
+
+using clock_type = std::chrono::steady_clock;
+
+static volatile double sink;
+
+// what ArrayListIterator used to be
+template <typename T> struct index_iterator {
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T *;
+  using reference = T &;
+
+  T *data = nullptr;
+  std::size_t idx = 0;
+
+  index_iterator &operator++() {
+    ++idx;
+    return *this;
+  }
+  index_iterator operator++(int) { return {data, idx++}; }
+  index_iterator &operator--() {
+    --idx;
+    return *this;
+  }
+  index_iterator operator--(int) { return {data, idx--}; }
+  index_iterator &operator+=(difference_type n) {
+    idx += static_cast<std::size_t>(n);
+    return *this;
+  }
+  index_iterator &operator-=(difference_type n) {
+    idx -= static_cast<std::size_t>(n);
+    return *this;
+  }
+  friend index_iterator operator+(index_iterator it, difference_type n) {
+    return it += n;
+  }
+  friend index_iterator operator+(difference_type n, index_iterator it) {
+    return it += n;
+  }
+  friend index_iterator operator-(index_iterator it, difference_type n) {
+    return it -= n;
+  }
+  difference_type operator-(const index_iterator &other) const {
+    return static_cast<difference_type>(idx) -
+           static_cast<difference_type>(other.idx);
+  }
+  bool operator==(const index_iterator &other) const {
+    return idx == other.idx;
+  }
+  auto operator<=>(const index_iterator &other) const {
+    return idx <=> other.idx;
+  }
+  T &operator*() const { return data[idx]; }
+  T &operator[](difference_type n) const {
+    return data[idx + static_cast<std::size_t>(n)];
+  }
+};
+
+template <typename F> double ms(F f) {
+  auto start = clock_type::now();
+  f();
+  return std::chrono::duration<double, std::milli>(clock_type::now() - start)
+      .count();
+}
+
+template <typename It>
+void run(const char *name, It first, It last, const std::vector<double> &input,
+         std::size_t reps) {
+  std::copy(input.begin(), input.end(), first);
+  double sort_ms = ms([&] { std::sort(first, last); });
+  double reduce_ms = ms([&] {
+    double sum = 0;
+    for (std::size_t r = 0; r < reps; ++r)
+      sum += std::reduce(std::execution::par_unseq, first, last, 0.0);
+    sink = sum;
+  });
+  std::printf("%-22s %12.1f ms %12.2f ms\n", name, sort_ms,
+              reduce_ms / static_cast<double>(reps));
+}
+
+int main(int argc, char **argv) {
+  std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+  std::size_t reps = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20;
+
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> dist(0, 1);
+  std::vector<double> input(n);
+  for (double &x : input)
+    x = dist(rng);
+
+  ArrayList<double> list;
+  list.reserve(n);
+  for (std::size_t i = 0; i < n; ++i)
+    list.append(0);
+  std::vector<double> vec(n);
+
+  std::printf("%zu doubles\n%-22s %15s %15s\n", n, "container", "std::sort",
+              "std::reduce");
+  run("ArrayList", list.begin(), list.end(), input, reps);
+  run("std::vector", vec.begin(), vec.end(), input, reps);
+  run("index iterator", index_iterator<double>{list.data(), 0},
+      index_iterator<double>{list.data(), n}, input, reps);
+}
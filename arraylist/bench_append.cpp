@@ -0,0 +1,79 @@
+#include "ArrayList.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+/**
+ * Appends n ints one at a time to an ArrayList and reports the time and the
+ * number of heap allocations, counted by replacing the global operator new.
+ *
+ * The old append reallocated an array of exactly size + 1 elements and copied
+ * everything over on every call. That behaviour is reproduced by
+ * exact_size_list below; being quadratic it is only run up to a much smaller
+ * size and the time for n is extrapolated from there.
+ *
+ * usage: ./bench_append [n, default 10000000] [n for the old behaviour,
+ *        default 200000]
+ */
+
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t n) {
+  ++allocations;
+  if (void *p = std::malloc(n))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+using clock_type = std::chrono::steady_clock;
+
+static volatile int sink;
+
+// what ArrayList::append used to do
+struct exact_size_list {
+  std::unique_ptr<int[]> data;
+  std::size_t _size = 0;
+
+  void append(int val) {
+    std::unique_ptr<int[]> tmp = std::make_unique<int[]>(_size + 1);
+    std::copy(data.get(), data.get() + _size, tmp.get());
+    tmp[_size++] = val;
+    data = std::move(tmp);
+  }
+
+  int &operator[](std::size_t idx) { return data[idx]; }
+};
+
+template <typename List> double run(const char *name, std::size_t n) {
+  std::size_t before = allocations;
+  auto start = clock_type::now();
+  {
+    List list;
+    for (std::size_t i = 0; i < n; ++i)
+      list.append(static_cast<int>(i));
+    sink = list[n - 1];
+  }
+  double seconds =
+      std::chrono::duration<double>(clock_type::now() - start).count();
+  std::printf("%-24s %12zu %12.3f s %10.2f ns/append %12zu allocations\n",
+              name, n, seconds, seconds * 1e9 / static_cast<double>(n),
+              allocations - before);
+  return seconds;
+}
+
+int main(int argc, char **argv) {
+  std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+  std::size_t old_n = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000;
+
+  run<ArrayList<int>>("ArrayList::append", n);
+  double old_seconds = run<exact_size_list>("exact size reallocation", old_n);
+  double ratio = static_cast<double>(n) / static_cast<double>(old_n);
+  std::printf("%-24s %12zu %12.0f s (extrapolated, quadratic)\n",
+              "exact size reallocation", n, old_seconds * ratio * ratio);
+}
@@ -0,0 +1,87 @@
+#include "ArrayList.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+/**
+ * Simulates request handling that builds a few short lived ArrayLists per
+ * request and throws them away at the end, once with the default allocator
+ * and once with a request scoped arena: a std::pmr::monotonic_buffer_resource
+ * over a buffer that is reused for every request and released when it ends.
+ * Reports the time per request and the number of global heap allocations,
+ * counted by replacing the global operator new.
+ *
+ * usage: ./bench_arena [requests, default 200000] [lists per request,
+ *        default 16] [elements per list, default 64]
+ */
+
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t n) {
+  ++allocations;
+  if (void *p = std::malloc(n))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+using clock_type = std::chrono::steady_clock;
+
+static volatile long sink;
+
+template <typename List, typename Make>
+long handle_request(std::size_t lists, std::size_t elements, Make make) {
+  long sum = 0;
+  for (std::size_t i = 0; i < lists; ++i) {
+    List list = make();
+    for (std::size_t j = 0; j < elements; ++j)
+      list.append(static_cast<long>(i + j));
+    for (long value : list)
+      sum += value;
+  }
+  return sum;
+}
+
+template <typename F>
+void report(const char *name, std::size_t requests, F f) {
+  std::size_t before = allocations;
+  auto start = clock_type::now();
+  long sum = 0;
+  for (std::size_t r = 0; r < requests; ++r)
+    sum += f();
+  double us = std::chrono::duration<double, std::micro>(clock_type::now() -
+                                                        start)
+                  .count();
+  sink = sum;
+  std::printf("%-16s %12.3f us/request %14zu allocations\n", name,
+              us / static_cast<double>(requests), allocations - before);
+}
+
+int main(int argc, char **argv) {
+  std::size_t requests =
+      argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+  std::size_t lists = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 16;
+  std::size_t elements = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 64;
+
+  std::printf("%zu requests of %zu lists of %zu longs\n", requests, lists,
+              elements);
+  report("global heap", requests, [&] {
+    return handle_request<ArrayList<long>>(lists, elements,
+                                           [] { return ArrayList<long>(); });
+  });
+
+  using arena_list =
+      ArrayList<long, 0, std::pmr::polymorphic_allocator<long>>;
+  std::vector<std::byte> buffer(1 << 20);
+  report("arena", requests, [&] {
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+    return handle_request<arena_list>(lists, elements,
+                                      [&] { return arena_list(&arena); });
+  });
+}
@@ -0,0 +1,65 @@
+#include "ArrayList.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+/**
+ * Times single element insert/remove pairs near the front, middle and end of a
+ * large ArrayList, and counts heap allocations by replacing the global
+ * operator new. Edits shift whichever side of the edit point is shorter
+ * within the existing buffer, so the cost peaks in the middle of the list and
+ * no edit allocates.
+ *
+ * usage: ./bench_edit [list size, default 1000000] [edits, default 1000]
+ */
+
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t n) {
+  ++allocations;
+  if (void *p = std::malloc(n))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+using clock_type = std::chrono::steady_clock;
+
+int main(int argc, char **argv) {
+  std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  std::size_t edits = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+
+  ArrayList<int> list;
+  list.reserve(n + 1);
+  for (std::size_t i = 0; i < n; ++i)
+    list.append(static_cast<int>(i));
+
+  std::printf("%-10s %14s %14s\n", "position", "us/edit", "allocations");
+  for (double at : {0.0, 0.5, 0.9, 0.999}) {
+    auto index = static_cast<std::size_t>(at * static_cast<double>(n));
+    std::size_t before = allocations;
+    auto start = clock_type::now();
+    for (std::size_t i = 0; i < edits; ++i) {
+      list.insert(index, -1);
+      list.remove(index);
+    }
+    double us = std::chrono::duration<double, std::micro>(clock_type::now() -
+                                                          start)
+                    .count();
+    std::printf("%9.1f%% %14.2f %14zu\n", at * 100, us / (2.0 * static_cast<double>(edits)),
+                allocations - before);
+  }
+  std::size_t before = allocations;
+  auto start = clock_type::now();
+  for (std::size_t i = 0; i < edits; ++i)
+    list.popleft();
+  double us =
+      std::chrono::duration<double, std::micro>(clock_type::now() - start)
+          .count();
+  std::printf("%-10s %14.2f %14zu\n", "popleft",
+              us / static_cast<double>(edits), allocations - before);
+}
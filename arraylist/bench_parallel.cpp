@@ -0,0 +1,97 @@
+#include "ArrayList.hpp"
+#include "ParallelArrayList.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <thread>
+
+/**
+ * Times parallel_map, parallel_filter, parallel_reduce and parallel_sort over
+ * an ArrayList of doubles on pools of 1, 2, 4, ... threads up to the number of
+ * hardware threads, next to the serial std algorithm doing the same work.
+ * The speedup column is relative to the serial algorithm.
+ *
+ * usage: ./bench_parallel [n, default 10000000] [most threads, default the
+ *        number of hardware threads]
+ */
+
+using clock_type = std::chrono::steady_clock;
+
+static volatile double sink;
+
+template <typename F> double ms(F f) {
+  auto start = clock_type::now();
+  f();
+  return std::chrono::duration<double, std::milli>(clock_type::now() - start)
+      .count();
+}
+
+int main(int argc, char **argv) {
+  std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+  std::size_t max_threads =
+      argc > 2 ? std::strtoul(argv[2], nullptr, 10)
+               : std::max(1U, std::thread::hardware_concurrency());
+
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> dist(0, 1);
+  ArrayList<double> list;
+  list.reserve(n);
+  for (std::size_t i = 0; i < n; ++i)
+    list.append(dist(rng));
+
+  // enough work per element that the memory bus is not the only limit
+  auto map = [](double x) { return std::sqrt(x) * std::log1p(x); };
+  auto pred = [](double x) { return x < 0.5; };
+
+  double serial_map = ms([&] {
+    ArrayList<double> out;
+    out.resize(n);
+    std::transform(list.begin(), list.end(), out.begin(), map);
+    sink = out[n / 2];
+  });
+  double serial_filter = ms([&] {
+    ArrayList<double> out;
+    for (double x : list) {
+      if (pred(x))
+        out.append(x);
+    }
+    sink = static_cast<double>(out.size());
+  });
+  double serial_reduce =
+      ms([&] { sink = std::accumulate(list.begin(), list.end(), 0.0); });
+  double serial_sort = ms([&] {
+    ArrayList<double> copy = list;
+    std::sort(copy.begin(), copy.end());
+    sink = copy[0];
+  });
+
+  std::printf("%zu doubles, %u hardware threads, times in ms\n", n,
+              std::thread::hardware_concurrency());
+  std::printf("%-8s %9s %9s %9s %9s\n", "threads", "map", "filter", "reduce",
+              "sort");
+  std::printf("%-8s %9.1f %9.1f %9.1f %9.1f\n", "serial", serial_map,
+              serial_filter, serial_reduce, serial_sort);
+  for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+    ThreadPool pool(threads);
+    double map_ms = ms([&] { sink = parallel_map(list, map, pool)[n / 2]; });
+    double filter_ms = ms([&] {
+      sink = static_cast<double>(parallel_filter(list, pred, pool).size());
+    });
+    double reduce_ms =
+        ms([&] { sink = parallel_reduce(list, 0.0, std::plus<>(), pool); });
+    double sort_ms = ms([&] {
+      ArrayList<double> copy = list;
+      parallel_sort(copy, std::less<>(), pool);
+      sink = copy[0];
+    });
+    std::printf("%-8zu %9.1f %9.1f %9.1f %9.1f   speedup %.2fx %.2fx %.2fx "
+                "%.2fx\n",
+                threads, map_ms, filter_ms, reduce_ms, sort_ms,
+                serial_map / map_ms, serial_filter / filter_ms,
+                serial_reduce / reduce_ms, serial_sort / sort_ms);
+  }
+}
@@ -0,0 +1,131 @@
+#include "ArrayList.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <vector>
+
+/**
+ * Uses an ArrayList as a queue and as a stack growing at the front, and reports
+ * the time per operation and the number of heap allocations, counted by
+ * replacing the global operator new. std::deque runs the same workloads for
+ * comparison.
+ *
+ * The old appendleft and popleft shifted every element by one. That behaviour
+ * is reproduced by shifting_list below; being linear per operation it is run
+ * on a smaller list and the time per operation for n is extrapolated from
+ * there.
+ *
+ * usage: ./bench_queue [queue length, default 1000000] [operations, default
+ *        10000000] [queue length for the old behaviour, default 100000]
+ */
+
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t n) {
+  ++allocations;
+  if (void *p = std::malloc(n))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+using clock_type = std::chrono::steady_clock;
+
+static volatile long sink;
+
+// what ArrayList::appendleft and popleft used to do
+struct shifting_list {
+  std::vector<int> data;
+
+  void append(int val) { data.push_back(val); }
+  void appendleft(int val) { data.insert(data.begin(), val); }
+
+  int popleft() {
+    int ret = data.front();
+    data.erase(data.begin());
+    return ret;
+  }
+};
+
+struct deque_list {
+  std::deque<int> data;
+
+  void append(int val) { data.push_back(val); }
+  void appendleft(int val) { data.push_front(val); }
+
+  int popleft() {
+    int ret = data.front();
+    data.pop_front();
+    return ret;
+  }
+};
+
+template <typename F>
+double report(const char *name, const char *workload, std::size_t ops, F f) {
+  std::size_t before = allocations;
+  auto start = clock_type::now();
+  f();
+  double ns = std::chrono::duration<double, std::nano>(clock_type::now() -
+                                                       start)
+                  .count() /
+              static_cast<double>(ops);
+  std::printf("%-16s %-22s %12zu %10.2f ns/op %12zu allocations\n", name,
+              workload, ops, ns, allocations - before);
+  return ns;
+}
+
+// a queue of n elements with ops append/popleft pairs on top
+template <typename List>
+double queue(const char *name, std::size_t n, std::size_t ops) {
+  List list;
+  for (std::size_t i = 0; i < n; ++i)
+    list.append(static_cast<int>(i));
+  return report(name, "append + popleft", ops, [&] {
+    long sum = 0;
+    for (std::size_t i = 0; i < ops; ++i) {
+      list.append(static_cast<int>(i));
+      sum += list.popleft();
+    }
+    sink = sum;
+  });
+}
+
+// n appendlefts onto an empty list, then n popleft
+template <typename List> double stack(const char *name, std::size_t n) {
+  List list;
+  return report(name, "appendleft + popleft", 2 * n, [&] {
+    for (std::size_t i = 0; i < n; ++i)
+      list.appendleft(static_cast<int>(i));
+    long sum = 0;
+    for (std::size_t i = 0; i < n; ++i)
+      sum += list.popleft();
+    sink = sum;
+  });
+}
+
+int main(int argc, char **argv) {
+  std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  std::size_t ops = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10000000;
+  std::size_t old_n = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 100000;
+  std::size_t old_ops = ops / 1000 > 0 ? ops / 1000 : 1;
+  double ratio = static_cast<double>(n) / static_cast<double>(old_n);
+
+  std::printf("queue of %zu ints\n", n);
+  queue<ArrayList<int>>("ArrayList", n, ops);
+  queue<deque_list>("std::deque", n, ops);
+  double old_ns = queue<shifting_list>("shifting", old_n, old_ops);
+  std::printf("%-16s %-22s %12zu %10.2f ns/op (extrapolated, linear)\n",
+              "shifting", "append + popleft", ops, old_ns * ratio);
+
+  std::printf("\nstack of %zu ints built at the front\n", n);
+  stack<ArrayList<int>>("ArrayList", n);
+  stack<deque_list>("std::deque", n);
+  old_ns = stack<shifting_list>("shifting", old_n);
+  std::printf("%-16s %-22s %12zu %10.2f ns/op (extrapolated, linear)\n",
+              "shifting", "appendleft + popleft", 2 * n, old_ns * ratio);
+}
@@ -0,0 +1,76 @@
+#include "ArrayList.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+/**
+ * Builds millions of tiny lists of 0 to 7 ints, sums them and destroys them,
+ * and reports the time and the number of heap allocations, counted by
+ * replacing the global operator new. A plain ArrayList allocates for every
+ * list that is not empty, and a SmallArrayList keeps all of them inline. The
+ * lists themselves live in one std::vector, which is one more allocation.
+ *
+ * usage: ./bench_small [number of lists, default 4000000]
+ */
+
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t n) {
+  ++allocations;
+  if (void *p = std::malloc(n))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+using clock_type = std::chrono::steady_clock;
+
+static volatile long sink;
+
+struct vector_list : std::vector<int> {
+  void append(int val) { push_back(val); }
+};
+
+template <typename List>
+void run(const char *name, const std::vector<unsigned char> &sizes) {
+  std::size_t before = allocations;
+  auto start = clock_type::now();
+  {
+    std::vector<List> lists(sizes.size());
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+      for (int j = 0; j < sizes[i]; ++j)
+        lists[i].append(j);
+    }
+    long sum = 0;
+    for (auto &list : lists) {
+      for (int value : list)
+        sum += value;
+    }
+    sink = sum;
+  }
+  double seconds =
+      std::chrono::duration<double>(clock_type::now() - start).count();
+  std::printf("%-22s %10zu bytes %10.3f s %14zu allocations\n", name,
+              sizeof(List), seconds, allocations - before);
+}
+
+int main(int argc, char **argv) {
+  std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+
+  std::mt19937 rng(42);
+  std::vector<unsigned char> sizes(n);
+  for (auto &size : sizes)
+    size = static_cast<unsigned char>(rng() % 8);
+
+  std::printf("%zu lists of 0 to 7 ints\n", n);
+  run<ArrayList<int>>("ArrayList<int>", sizes);
+  run<SmallArrayList<int, 8>>("SmallArrayList<int, 8>", sizes);
+  run<SmallArrayList<int, 4>>("SmallArrayList<int, 4>", sizes);
+  run<vector_list>("std::vector<int>", sizes);
+}
@@ -0,0 +1,87 @@
+#include "ArrayList.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+/**
+ * Reads slices of a large ArrayList once each, first copied out with slice and
+ * then through slice_view, and sums the concatenation of two lists built with
+ * operator+ and read through concat_view. Reports the time and the number of
+ * heap allocations, counted by replacing the global operator new.
+ *
+ * usage: ./bench_views [list size, default 1000000] [slices, default 100000]
+ *        [slice length, default 64]
+ */
+
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t n) {
+  ++allocations;
+  if (void *p = std::malloc(n))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+using clock_type = std::chrono::steady_clock;
+
+static volatile long sink;
+
+template <typename F> void report(const char *name, std::size_t ops, F f) {
+  std::size_t before = allocations;
+  auto start = clock_type::now();
+  long sum = f();
+  double us = std::chrono::duration<double, std::micro>(clock_type::now() -
+                                                        start)
+                  .count();
+  sink = sum;
+  std::printf("%-28s %12.3f us/op %12zu allocations\n", name,
+              us / static_cast<double>(ops), allocations - before);
+}
+
+int main(int argc, char **argv) {
+  std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  std::size_t slices = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+  std::size_t len = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 64;
+
+  ArrayList<long> list;
+  for (std::size_t i = 0; i < n; ++i)
+    list.append(static_cast<long>(i));
+  ArrayList<long> other = list;
+
+  std::printf("%zu slices of %zu longs\n", slices, len);
+  report("slice", slices, [&] {
+    long sum = 0;
+    for (std::size_t i = 0; i < slices; ++i) {
+      for (long value : list.slice((i * 7919) % (n - len), len))
+        sum += value;
+    }
+    return sum;
+  });
+  report("slice_view", slices, [&] {
+    long sum = 0;
+    for (std::size_t i = 0; i < slices; ++i) {
+      for (long value : list.slice_view((i * 7919) % (n - len), len))
+        sum += value;
+    }
+    return sum;
+  });
+
+  std::printf("\ntwo lists of %zu longs concatenated and summed\n", n);
+  report("operator+", 1, [&] {
+    long sum = 0;
+    for (long value : list + other)
+      sum += value;
+    return sum;
+  });
+  report("concat_view", 1, [&] {
+    long sum = 0;
+    for (long value : list.concat_view(other))
+      sum += value;
+    return sum;
+  });
+}
@@ -1,6 +1,20 @@
 #include "ArrayList.hpp"
+#include "ParallelArrayList.hpp"
+#include <algorithm>
 #include <assert.h>
+#include <atomic>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <ranges>
+#include <span>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 void test_access() {
   ArrayList<int> list;
@@ -58,6 +72,663 @@ void test_equality() {
   assert(list3 != list1);
 }
 
+void test_capacity() {
+  ArrayList<int> list;
+  assert(list.capacity() == 0);
+  std::size_t reallocations = 0;
+  std::size_t last_capacity = 0;
+  for (int i = 0; i < 10000; ++i) {
+    list.append(i);
+    assert(list.capacity() >= list.size());
+    if (list.capacity() != last_capacity) {
+      reallocations++;
+      last_capacity = list.capacity();
+    }
+  }
+  // geometric growth, not one reallocation per append
+  assert(reallocations < 20);
+  for (int i = 0; i < 10000; ++i) {
+    assert(list[i] == i);
+  }
+
+  list.reserve(20000);
+  assert(list.capacity() == 20000);
+  for (int i = 0; i < 10000; ++i) {
+    list.append(i);
+  }
+  assert(list.capacity() == 20000);
+  list.reserve(10);
+  assert(list.capacity() == 20000);
+
+  for (int i = 0; i < 15000; ++i) {
+    list.pop();
+  }
+  list.shrink_to_fit();
+  assert(list.capacity() == 5000 && list.size() == 5000);
+  assert(list[4999] == 4999);
+
+  ArrayList<std::string> strings;
+  std::string &s = strings.emplace_back(3, 'a');
+  assert(s == "aaa");
+  // appending an element of the list itself has to survive the reallocation
+  for (int i = 0; i < 100; ++i) {
+    strings.append(strings[0]);
+  }
+  assert(strings.size() == 101 && strings[100] == "aaa");
+  strings += strings;
+  assert(strings.size() == 202 && strings[201] == "aaa");
+
+  // the right operand may be the list being moved from or appended to
+  ArrayList<int> small = {1, 2, 3};
+  ArrayList<int> doubled = std::move(small) + small;
+  assert(doubled == ArrayList<int>({1, 2, 3, 1, 2, 3}));
+  doubled += std::move(doubled);
+  assert(doubled.size() == 12 && doubled[11] == 3);
+  ArrayList<std::string> words = {"a", "b"};
+  ArrayList<std::string> twice = std::move(words) + words;
+  assert(twice == ArrayList<std::string>({"a", "b", "a", "b"}));
+}
+
+void test_insert_remove() {
+  ArrayList<int> list;
+  list.appendleft(1);
+  list.insert(1, 3);
+  list.insert(1, 2);
+  list.appendleft(0);
+  for (int i = 0; i < 4; ++i) {
+    assert(list[i] == i);
+  }
+  try {
+    list.insert(5, 0);
+    assert(false && "insert error not caught");
+  } catch (const std::invalid_argument &) {
+  }
+
+  list.reserve(100);
+  std::size_t capacity = list.capacity();
+  list.insert(2, ArrayList<int>{10, 11, 12});
+  assert((list == ArrayList<int>{0, 1, 10, 11, 12, 2, 3}));
+  list.insert(0, list);
+  assert(list.size() == 14 && list[7] == 0 && list[13] == 3);
+  list.remove(0, 7);
+  assert((list == ArrayList<int>{0, 1, 10, 11, 12, 2, 3}));
+  list.remove(2);
+  list.remove(2, 2);
+  assert((list == ArrayList<int>{0, 1, 2, 3}));
+  assert(list.popleft() == 0);
+  list.insert(3, list[0]);
+  assert((list == ArrayList<int>{1, 2, 3, 1}));
+  // every edit above fit in the reserved capacity, so nothing reallocated
+  assert(list.capacity() == capacity);
+
+  // compare a long run of random edits against std::vector
+  ArrayList<std::string> strings;
+  std::vector<std::string> reference;
+  unsigned seed = 12345;
+  auto next = [&seed]() {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) & 0xFFFF;
+  };
+  for (int i = 0; i < 5000; ++i) {
+    std::size_t size = reference.size();
+    unsigned op = next() % 4;
+    if (op < 2 || size == 0) {
+      std::size_t index = next() % (size + 1);
+      std::string value = std::to_string(i);
+      strings.insert(index, value);
+      reference.insert(reference.begin() + index, value);
+    } else if (op == 2) {
+      std::size_t index = next() % size;
+      strings.remove(index);
+      reference.erase(reference.begin() + index);
+    } else {
+      assert(strings.popleft() == reference.front());
+      reference.erase(reference.begin());
+    }
+  }
+  assert(strings.size() == reference.size());
+  for (std::size_t i = 0; i < reference.size(); ++i) {
+    assert(strings[i] == reference[i]);
+  }
+}
+
+// not default constructible, and counts how often it is copied
+struct tracked {
+  static inline int copies = 0;
+  static inline int live = 0;
+  int value;
+
+  explicit tracked(int v) : value(v) { live++; }
+  tracked(const tracked &other) : value(other.value) {
+    copies++;
+    live++;
+  }
+  tracked(tracked &&other) noexcept : value(other.value) { live++; }
+  tracked &operator=(const tracked &other) {
+    value = other.value;
+    copies++;
+    return *this;
+  }
+  tracked &operator=(tracked &&other) noexcept {
+    value = other.value;
+    return *this;
+  }
+  ~tracked() { live--; }
+  bool operator==(const tracked &other) const { return value == other.value; }
+};
+
+void test_move_semantics() {
+  static_assert(std::is_nothrow_move_constructible_v<ArrayList<std::string>>);
+  static_assert(std::is_nothrow_move_assignable_v<ArrayList<std::string>>);
+  {
+    ArrayList<tracked> list;
+    for (int i = 0; i < 1000; ++i) {
+      list.append(tracked(i));
+    }
+    list.insert(500, tracked(-1));
+    list.appendleft(tracked(-2));
+    list.emplace_back(1000);
+    list.remove(0);
+    list.remove(500);
+    assert(list.popleft().value == 0);
+    assert(list.pop().value == 1000);
+    ArrayList<tracked> other;
+    other.append(tracked(7));
+    list += std::move(other);
+    list.insert(10, ArrayList<tracked>{});
+    ArrayList<tracked> moved(std::move(list));
+    list = std::move(moved);
+    assert(list.size() == 1000 && list[0].value == 1 && list[999].value == 7);
+    // nothing above had to copy an element
+    assert(tracked::copies == 0);
+    assert(tracked::live == 1000);
+
+    ArrayList<tracked> copy(list);
+    assert(tracked::copies == 1000 && copy == list);
+    ArrayList<tracked> slice = list.slice(10, 5);
+    assert(tracked::copies == 1005 && slice[0].value == 11);
+  }
+  // every element constructed was destroyed again
+  assert(tracked::live == 0);
+
+  ArrayList<std::unique_ptr<int>> owners;
+  for (int i = 0; i < 100; ++i) {
+    owners.append(std::make_unique<int>(i));
+  }
+  owners.insert(0, std::make_unique<int>(-1));
+  owners.remove(50);
+  assert(*owners.popleft() == -1);
+  assert(*owners.pop() == 99);
+  assert(owners.size() == 98 && *owners[0] == 0);
+
+  // a growing std::vector moves the lists, so their buffers stay put
+  std::vector<ArrayList<std::string>> lists(1);
+  lists[0].append("kept");
+  const std::string *buffer = &lists[0][0];
+  for (int i = 0; i < 100; ++i) {
+    lists.emplace_back();
+  }
+  assert(&lists[0][0] == buffer);
+
+  ArrayList<std::string> left{"a", "b"};
+  ArrayList<std::string> joined = std::move(left) + ArrayList<std::string>{"c"};
+  assert((joined == ArrayList<std::string>{"a", "b", "c"}));
+}
+
+void test_deque() {
+  // a steady queue settles on a capacity and then reuses the slots freed by
+  // popleft instead of growing
+  ArrayList<int> queue;
+  for (int i = 0; i < 64; ++i)
+    queue.append(i);
+  std::size_t capacity = 0;
+  for (int i = 64; i < 100000; ++i) {
+    assert(queue.popleft() == i - 64);
+    queue.append(i);
+    if (i == 1000)
+      capacity = queue.capacity();
+  }
+  assert(capacity <= 128);
+  assert(queue.size() == 64);
+  assert(queue.capacity() == capacity);
+  assert(queue[0] == 100000 - 64);
+
+  // and so does a stack that grows at the front
+  ArrayList<int> stack;
+  for (int i = 0; i < 1000; ++i)
+    stack.appendleft(i);
+  for (int i = 0; i < 1000; ++i)
+    assert(stack[i] == 999 - i);
+  capacity = stack.capacity();
+  for (int i = 0; i < 100000; ++i) {
+    stack.appendleft(i);
+    assert(stack.popleft() == i);
+  }
+  assert(stack.capacity() == capacity);
+
+  // compare random edits at both ends and in the middle against std::deque
+  ArrayList<std::string> strings;
+  std::deque<std::string> reference;
+  unsigned seed = 54321;
+  auto next = [&seed]() {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) & 0xFFFF;
+  };
+  for (int i = 0; i < 20000; ++i) {
+    std::size_t size = reference.size();
+    unsigned op = next() % 8;
+    std::string value = std::to_string(i);
+    if (op == 0 || size == 0) {
+      strings.appendleft(value);
+      reference.push_front(value);
+    } else if (op == 1) {
+      strings.append(value);
+      reference.push_back(value);
+    } else if (op == 2) {
+      assert(strings.popleft() == reference.front());
+      reference.pop_front();
+    } else if (op == 3) {
+      assert(strings.pop() == reference.back());
+      reference.pop_back();
+    } else if (op == 4) {
+      std::size_t index = next() % (size + 1);
+      strings.insert(index, value);
+      reference.insert(reference.begin() + index, value);
+    } else if (op == 5) {
+      std::size_t index = next() % (size + 1);
+      ArrayList<std::string> items = {value, value + "a", value + "b"};
+      strings.insert(index, items);
+      reference.insert(reference.begin() + index, items.begin(), items.end());
+    } else {
+      std::size_t index = next() % size;
+      strings.remove(index);
+      reference.erase(reference.begin() + index);
+    }
+  }
+  assert(strings.size() == reference.size());
+  assert(std::equal(strings.begin(), strings.end(), reference.begin(),
+                    reference.end()));
+  strings.reserve(strings.capacity());
+  assert(std::equal(strings.begin(), strings.end(), reference.begin(),
+                    reference.end()));
+  strings.shrink_to_fit();
+  assert(strings.capacity() == reference.size());
+  assert(std::equal(strings.begin(), strings.end(), reference.begin(),
+                    reference.end()));
+
+  // the iterators are random access
+  static_assert(std::random_access_iterator<ArrayListIterator<int>>);
+  static_assert(std::random_access_iterator<ArrayListConstIterator<int>>);
+  ArrayList<int> numbers = {5, 3, 9, 1, 7};
+  numbers.popleft();
+  numbers.appendleft(4);
+  std::sort(numbers.begin(), numbers.end());
+  assert((numbers == ArrayList<int>{1, 3, 4, 7, 9}));
+  auto it = numbers.begin();
+  assert(it[2] == 4);
+  assert(*(it + 4) == 9);
+  assert(numbers.end() - numbers.begin() == 5);
+  assert(it < numbers.end());
+  assert(*std::lower_bound(numbers.cbegin(), numbers.cend(), 6) == 7);
+}
+
+// whether the elements of list are stored inside the list object itself
+template <typename List> bool stored_inline(List &list) {
+  auto *first = reinterpret_cast<const char *>(&list);
+  auto *element = reinterpret_cast<const char *>(&list[0]);
+  return element >= first && element < first + sizeof(List);
+}
+
+void test_small_buffer() {
+  static_assert(std::is_nothrow_move_constructible_v<SmallArrayList<int>>);
+  static_assert(sizeof(ArrayList<int, 0>) == sizeof(ArrayList<int>));
+
+  SmallArrayList<int, 4> small;
+  assert(small.capacity() == 4);
+  for (int i = 0; i < 4; ++i)
+    small.append(i);
+  assert(small.capacity() == 4 && stored_inline(small));
+  assert(small.popleft() == 0);
+  small.appendleft(-1);
+  small.insert(2, 10);
+  assert(!stored_inline(small) && small.capacity() >= 5);
+  assert((small == SmallArrayList<int, 4>{-1, 1, 10, 2, 3}));
+  small.remove(0, 2);
+  small.shrink_to_fit();
+  assert(small.capacity() == 4 && stored_inline(small));
+  assert((small == SmallArrayList<int, 4>{10, 2, 3}));
+  std::sort(small.begin(), small.end());
+  assert(small[0] == 2 && small[2] == 10);
+
+  {
+    // moving and swapping inline lists moves the elements themselves, while
+    // lists on the heap still just hand their buffers over
+    SmallArrayList<tracked, 4> a;
+    a.append(tracked(1));
+    a.append(tracked(2));
+    SmallArrayList<tracked, 4> b(std::move(a));
+    assert(a.empty() && b.size() == 2 && stored_inline(b));
+    assert(tracked::live == 2);
+
+    SmallArrayList<tracked, 4> heap;
+    for (int i = 0; i < 10; ++i)
+      heap.append(tracked(i));
+    tracked *elements = &heap[0];
+    heap.swap(b);
+    assert(b.size() == 10 && &b[0] == elements);
+    assert(heap.size() == 2 && stored_inline(heap) && heap[1].value == 2);
+    b.swap(heap);
+    assert(&heap[0] == elements && b[0].value == 1 && stored_inline(b));
+
+    SmallArrayList<tracked, 4> c;
+    c.append(tracked(5));
+    c.swap(b);
+    assert(c.size() == 2 && b.size() == 1 && b[0].value == 5);
+    a = std::move(heap);
+    assert(&a[0] == elements && heap.empty() && heap.capacity() == 4);
+    int copies = tracked::copies;
+    heap = a;
+    assert(heap == a && !stored_inline(heap));
+    assert(tracked::copies == copies + 10);
+    assert(tracked::live == 2 + 1 + 10 + 10);
+  }
+  assert(tracked::live == 0);
+
+  SmallArrayList<std::unique_ptr<int>, 2> owners;
+  owners.append(std::make_unique<int>(1));
+  SmallArrayList<std::unique_ptr<int>, 2> moved(std::move(owners));
+  assert(*moved[0] == 1 && owners.empty());
+  moved.append(std::make_unique<int>(2));
+  moved.append(std::make_unique<int>(3));
+  owners = std::move(moved);
+  assert(owners.size() == 3 && *owners[2] == 3);
+}
+
+int sum(std::span<const int> values) {
+  int ret = 0;
+  for (int value : values)
+    ret += value;
+  return ret;
+}
+
+void test_views() {
+  ArrayList<int> list = {1, 2, 3, 4, 5};
+  assert(sum(list) == 15);
+  std::span<int> all = list;
+  assert(all.size() == 5 && all.data() == &list[0]);
+
+  std::span<int> middle = list.slice_view(1, 3);
+  assert(middle.size() == 3 && middle[0] == 2 && sum(middle) == 9);
+  middle[1] = 30;
+  assert(list[2] == 30);
+  assert(list.slice_view(5, 0).empty());
+  try {
+    list.slice_view(3, 3);
+    assert(false);
+  } catch (const std::invalid_argument &) {
+  }
+  const ArrayList<int> &constant = list;
+  std::span<const int> whole = constant;
+  assert(whole.size() == 5 && whole.data() == &constant[0]);
+  std::span<const int> tail = constant.slice_view(3, 2);
+  assert(tail[0] == 4 && tail[1] == 5);
+
+  ArrayList<int> second = {6, 7};
+  ArrayList<int> empty;
+  ArrayList<int> third = {8};
+  auto chained = list.concat_view(empty).concat_view(second).concat_view(third);
+  static_assert(std::ranges::forward_range<decltype(chained)>);
+  assert(chained.size() == 8);
+  assert(chained[0] == 1 && chained[5] == 6 && chained[7] == 8);
+  std::vector<int> read(chained.begin(), chained.end());
+  assert((read == std::vector<int>{1, 2, 30, 4, 5, 6, 7, 8}));
+  chained[6] = 70;
+  assert(second[1] == 70);
+  assert(std::ranges::count_if(chained, [](int v) { return v > 5; }) == 4);
+
+  auto halves = constant.concat_view(tail).concat_view(list.slice_view(0, 1));
+  static_assert(std::is_same_v<decltype(*halves.begin()), const int &>);
+  assert(halves.size() == 8 && halves[5] == 4 && halves[7] == 1);
+
+  ArrayListConcatView<int> none;
+  assert(none.empty() && none.begin() == none.end());
+  none.concat(empty.slice_view(0, 0));
+  assert(none.begin() == none.end());
+  none.concat(third);
+  assert(*none.begin() == 8 && ++none.begin() == none.end());
+}
+
+// a memory resource that counts what is allocated from it
+struct counting_resource : std::pmr::memory_resource {
+  std::size_t allocated = 0;
+  std::size_t live = 0;
+
+  void *do_allocate(std::size_t bytes, std::size_t align) override {
+    allocated++;
+    live++;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+
+  void do_deallocate(void *p, std::size_t bytes, std::size_t align) override {
+    live--;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+
+  bool do_is_equal(const memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+};
+
+void test_allocator() {
+  using pmr_list = ArrayList<std::string, 0,
+                             std::pmr::polymorphic_allocator<std::string>>;
+  counting_resource resource;
+  counting_resource other_resource;
+  {
+    pmr_list list(&resource);
+    for (int i = 0; i < 100; ++i)
+      list.append(std::to_string(i));
+    list.appendleft("front");
+    assert(resource.live == 1 && resource.allocated > 1);
+    assert(list.get_allocator().resource() == &resource);
+
+    // copies go to the default resource unless given one
+    pmr_list copy(list);
+    assert(copy == list && copy.get_allocator().resource() != &resource);
+    pmr_list same(list, &resource);
+    assert(same == list && resource.live == 2);
+    assert(list.slice(0, 3).get_allocator().resource() != &resource);
+
+    // assignment keeps the resource of the list assigned to, moving the
+    // elements over one by one if the resources differ
+    pmr_list other(&other_resource);
+    other = list;
+    assert(other == list && other_resource.live == 1);
+    other = std::move(same);
+    assert(other == list && same.empty() && other_resource.live == 1);
+    assert(other.get_allocator().resource() == &other_resource);
+    pmr_list taken(&resource);
+    std::size_t allocated = resource.allocated;
+    taken = std::move(list);
+    assert(taken == other && list.empty() && resource.allocated == allocated);
+
+    SmallArrayList<int, 4, std::pmr::polymorphic_allocator<int>> small(
+        &resource);
+    small.append(1);
+    assert(resource.allocated == allocated);
+    for (int i = 0; i < 10; ++i)
+      small.append(i);
+    assert(resource.allocated > allocated);
+  }
+  assert(resource.live == 0 && other_resource.live == 0);
+}
+
+void test_contiguous() {
+  static_assert(std::contiguous_iterator<ArrayList<int>::iterator>);
+  static_assert(std::contiguous_iterator<ArrayList<int>::const_iterator>);
+  static_assert(std::ranges::contiguous_range<ArrayList<std::string>>);
+  static_assert(std::ranges::contiguous_range<const ArrayList<int>>);
+  static_assert(std::ranges::sized_range<ArrayList<int>>);
+
+  ArrayList<int> list;
+  for (int i = 0; i < 100; ++i)
+    list.append((i * 37) % 100);
+  list.appendleft(list.popleft());
+  assert(list.data() == &list[0]);
+  assert(std::to_address(list.begin()) == list.data());
+  assert(std::to_address(list.end()) == list.data() + list.size());
+
+  std::ranges::sort(list);
+  assert(std::ranges::is_sorted(list));
+  assert(*std::ranges::lower_bound(list, 50) == 50);
+  std::sort(list.rbegin(), list.rend());
+  assert(list[0] == 99 && list[99] == 0);
+  ArrayList<int>::const_iterator it = list.begin();
+  assert(it == list.cbegin() && it[1] == 98);
+
+  const ArrayList<int> &constant = list;
+  int expected = 0;
+  for (auto rit = constant.crbegin(); rit != constant.crend(); ++rit)
+    assert(*rit == expected++);
+  assert(std::distance(constant.rbegin(), constant.rend()) == 100);
+  std::span<const int> view(constant.begin(), constant.end());
+  assert(view.data() == constant.data());
+}
+
+template <typename T> T from_int(int value) {
+  if constexpr (std::is_same_v<T, std::string>)
+    return std::to_string(value);
+  else
+    return static_cast<T>(value);
+}
+
+// checks find, count, contains and == against the std algorithms on lists of
+// every length up to 100, so that both the vector loops and their tails run
+template <typename T> void check_search() {
+  unsigned seed = 777;
+  auto next = [&seed]() {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) & 0xFFFF;
+  };
+  for (std::size_t n = 0; n <= 100; ++n) {
+    ArrayList<T> list;
+    for (std::size_t i = 0; i < n; ++i)
+      list.append(from_int<T>(static_cast<int>(next() % 8)));
+    for (int v = 0; v < 9; ++v) {
+      T value = from_int<T>(v);
+      auto expected = std::find(list.cbegin(), list.cend(), value);
+      assert(std::as_const(list).find(value) == expected);
+      assert(list.find(value) - list.begin() == expected - list.cbegin());
+      assert(list.contains(value) == (expected != list.cend()));
+      assert(list.count(value) ==
+             static_cast<std::size_t>(std::count(list.begin(), list.end(),
+                                                 value)));
+    }
+    ArrayList<T> copy = list;
+    assert(copy == list);
+    if (n > 0) {
+      copy[next() % n] = from_int<T>(9);
+      assert(!(copy == list));
+    }
+  }
+}
+
+void test_search() {
+  check_search<signed char>();
+  check_search<unsigned short>();
+  check_search<int>();
+  check_search<long long>();
+  check_search<float>();
+  check_search<double>();
+  check_search<std::string>();
+
+  // floating point elements compare by value, not by their bytes
+  double nan = std::numeric_limits<double>::quiet_NaN();
+  ArrayList<double> values = {1, 2, 3, 4, 5, 6, 7, nan, -0.0};
+  assert(!values.contains(nan) && values.count(nan) == 0);
+  assert(values.find(0.0) - values.begin() == 8);
+  assert(!(values == values));
+  ArrayList<float> zeros = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  ArrayList<float> negative = {-0.0f, -0.0f, -0.0f, -0.0f, -0.0f};
+  assert(zeros == negative);
+}
+
+void test_resize() {
+  ArrayList<std::string> list = {"a", "b", "c"};
+  list.resize(5);
+  assert(list.size() == 5 && list[2] == "c" && list[4].empty());
+  list.resize(2);
+  assert((list == ArrayList<std::string>{"a", "b"}));
+  list.resize(4, list[0]);
+  assert((list == ArrayList<std::string>{"a", "b", "a", "a"}));
+  list.resize(0);
+  assert(list.empty());
+}
+
+void test_parallel() {
+  ArrayList<long> numbers;
+  for (long i = 0; i < 100000; ++i)
+    numbers.append((i * 7919) % 100003);
+  for (std::size_t threads : {1, 2, 4}) {
+    ThreadPool pool(threads);
+    assert(pool.concurrency() == threads);
+
+    auto squares =
+        parallel_map(numbers, [](long x) { return x * x; }, pool);
+    assert(squares.size() == numbers.size());
+    for (std::size_t i = 0; i < numbers.size(); ++i)
+      assert(squares[i] == numbers[i] * numbers[i]);
+    auto strings =
+        parallel_map(numbers, [](long x) { return std::to_string(x); }, pool);
+    assert(strings[123] == std::to_string(numbers[123]));
+
+    auto odd = parallel_filter(numbers, [](long x) { return x % 2; }, pool);
+    ArrayList<long> expected;
+    for (long x : numbers) {
+      if (x % 2)
+        expected.append(x);
+    }
+    assert(odd == expected);
+    assert(parallel_filter(numbers, [](long) { return false; }, pool).empty());
+
+    long sum = 0;
+    for (long x : numbers)
+      sum += x;
+    assert(parallel_reduce(numbers, 0L, std::plus<>(), pool) == sum);
+    // the chunks are combined in order, so op need not commute
+    assert(parallel_reduce(strings, std::string(), std::plus<>(), pool) ==
+           std::accumulate(strings.begin(), strings.end(), std::string()));
+
+    ArrayList<long> sorted = numbers;
+    parallel_sort(sorted, std::less<>(), pool);
+    assert(std::is_sorted(sorted.begin(), sorted.end()));
+    assert(parallel_reduce(sorted, 0L, std::plus<>(), pool) == sum);
+    parallel_sort(sorted, std::greater<>(), pool);
+    assert(std::is_sorted(sorted.rbegin(), sorted.rend()));
+
+    // tasks may use the pool they run on
+    std::atomic<int> inner{0};
+    pool.run(8, [&](std::size_t) {
+      pool.run(8, [&](std::size_t) { ++inner; });
+    });
+    assert(inner == 64);
+
+    try {
+      pool.run(100, [](std::size_t i) {
+        if (i == 42)
+          throw std::runtime_error("task failed");
+      });
+      assert(false);
+    } catch (const std::runtime_error &e) {
+      assert(std::string(e.what()) == "task failed");
+    }
+  }
+  ArrayList<int> small = {3, 1, 2};
+  parallel_sort(small);
+  assert((small == ArrayList<int>{1, 2, 3}));
+  assert(parallel_reduce(ArrayList<int>(), 5) == 5);
+}
+
 int main(void) {
   std::cout << "Starting tests...\n";
   test_access();
@@ -66,5 +737,27 @@ int main(void) {
   std::cout << "test iterator passed\n";
   test_equality();
   std::cout << "test equality passed\n";
+  test_capacity();
+  std::cout << "test capacity passed\n";
+  test_insert_remove();
+  std::cout << "test insert remove passed\n";
+  test_move_semantics();
+  std::cout << "test move semantics passed\n";
+  test_deque();
+  std::cout << "test deque passed\n";
+  test_small_buffer();
+  std::cout << "test small buffer passed\n";
+  test_views();
+  std::cout << "test views passed\n";
+  test_allocator();
+  std::cout << "test allocator passed\n";
+  test_contiguous();
+  std::cout << "test contiguous passed\n";
+  test_search();
+  std::cout << "test search passed\n";
+  test_resize();
+  std::cout << "test resize passed\n";
+  test_parallel();
+  std::cout << "test parallel passed\n";
   std::cout << "All Tests Passed\n";
 }
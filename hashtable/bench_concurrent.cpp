@@ -0,0 +1,98 @@
+#include "concurrent_hashtable.hpp"
+#include "hashtable.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+/**
+ * Multi-threaded throughput of concurrent_hashtable against a plain hashtable behind one global mutex, from 1 thread
+ * up to max threads, at several read/write mixes. Each thread runs a fixed number of operations on random keys from
+ * a shared key space; writes alternate between insert_or_assign and erase.
+ *
+ * usage: ./bench_concurrent [max threads, default 64] [operations per thread, default 200000]
+ */
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr std::size_t key_space = 1 << 20;
+
+/**
+ * The obvious way to share a hashtable: every operation takes the same lock.
+ */
+class global_lock_hashtable {
+  mutable std::mutex lock;
+  hashtable<std::size_t, std::size_t> table;
+
+public:
+  explicit global_lock_hashtable(std::size_t n) { table.reserve(n); }
+
+  void insert_or_assign(std::size_t key, std::size_t value) {
+    std::lock_guard guard(lock);
+    table.insert_or_assign(key, value);
+  }
+
+  void erase(std::size_t key) {
+    std::lock_guard guard(lock);
+    if (table.contains(key)) { table.erase(key); }
+  }
+
+  bool contains(std::size_t key) const {
+    std::lock_guard guard(lock);
+    return table.contains(key);
+  }
+};
+
+template<typename Table> double mops(Table &table, std::size_t threads, std::size_t ops, unsigned read_percent) {
+  std::vector<std::thread> workers;
+  std::vector<std::size_t> hits(threads);
+  auto start = clock_type::now();
+  for (std::size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&table, &hits, t, ops, read_percent] {
+      std::mt19937_64 rng(t);
+      std::size_t found = 0;
+      for (std::size_t i = 0; i < ops; ++i) {
+        std::size_t r = rng();
+        std::size_t key = r % key_space;
+        if ((r >> 32) % 100 < read_percent) {
+          found += table.contains(key);
+        } else if (i % 2 == 0) {
+          table.insert_or_assign(key, r);
+        } else {
+          table.erase(key);
+        }
+      }
+      hits[t] = found;
+    });
+  }
+  for (auto &worker : workers) { worker.join(); }
+  auto seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+  return static_cast<double>(threads * ops) / seconds / 1e6;
+}
+
+template<typename Table> void prefill(Table &table) {
+  for (std::size_t key = 0; key < key_space; key += 2) { table.insert_or_assign(key, key); }
+}
+
+int main(int argc, char **argv) {
+  std::size_t max_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+  std::size_t ops = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000;
+
+  std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+  std::printf("%8s %8s %16s %16s\n", "reads %", "threads", "global Mops/s", "sharded Mops/s");
+  for (unsigned read_percent : { 50U, 90U, 99U }) {
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+      // sized for the whole key space up front so that no rehash lands inside the timed section
+      global_lock_hashtable global(key_space);
+      concurrent_hashtable<std::size_t, std::size_t> sharded(key_space);
+      prefill(global);
+      prefill(sharded);
+      double global_mops = mops(global, threads, ops, read_percent);
+      double sharded_mops = mops(sharded, threads, ops, read_percent);
+      std::printf("%8u %8zu %16.2f %16.2f\n", read_percent, threads, global_mops, sharded_mops);
+    }
+  }
+}
@@ -0,0 +1,97 @@
+#include "flat_hashtable.hpp"
+#include "hashtable.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+ * Compares find_batch against calling find once per key, and insert_bulk against calling insert once per key, on
+ * tables far larger than the last level cache so that nearly every probe is a cache miss. The lookups are random hits
+ * handed to find_batch a few thousand at a time, the way an ingest path would.
+ *
+ * usage: ./bench_find_batch [log2 number of entries, default 25] [number of lookups, default 10000000]
+ */
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr std::size_t lookup_chunk = 4096;
+
+static volatile std::size_t sink;
+
+template<typename F> double ns_per_op(std::size_t ops, F &&f) {
+  auto start = clock_type::now();
+  f();
+  auto elapsed = std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+  return elapsed / static_cast<double>(ops);
+}
+
+template<typename Table>
+void run(const char *name,
+  const std::vector<std::pair<std::size_t, std::size_t>> &entries,
+  const std::vector<std::size_t> &lookups) {
+  double insert_one = 0;
+  {
+    Table table;
+    insert_one = ns_per_op(entries.size(), [&] {
+      for (const auto &[key, value] : entries) { table.insert(key, value); }
+    });
+  }
+
+  Table table;
+  double insert_bulk = ns_per_op(entries.size(), [&] { table.insert_bulk(entries); });
+
+  double find_one = ns_per_op(lookups.size(), [&] {
+    std::size_t sum = 0;
+    for (std::size_t key : lookups) { sum += table.find(key)->second; }
+    sink = sum;
+  });
+
+  std::vector<typename Table::iterator> found(lookup_chunk);
+  double find_batch = ns_per_op(lookups.size(), [&] {
+    std::size_t sum = 0;
+    for (std::size_t start = 0; start < lookups.size(); start += lookup_chunk) {
+      std::span<const std::size_t> chunk(lookups.data() + start, std::min(lookup_chunk, lookups.size() - start));
+      auto last = table.find_batch(chunk, found.begin());
+      for (auto it = found.begin(); it != last; ++it) { sum += (*it)->second; }
+    }
+    sink = sum;
+  });
+
+  std::printf("%-10s %14.1f %14.1f %14.1f %14.1f %10.2fx\n",
+    name,
+    insert_one,
+    insert_bulk,
+    find_one,
+    find_batch,
+    find_one / find_batch);
+}
+
+int main(int argc, char **argv) {
+  std::size_t log2_n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 25;
+  std::size_t lookups_n = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10000000;
+  std::size_t n = std::size_t{ 1 } << log2_n;
+
+  std::mt19937_64 rng(42);
+  std::vector<std::pair<std::size_t, std::size_t>> entries(n);
+  for (auto &[key, value] : entries) {
+    key = rng();
+    value = key >> 1;
+  }
+  std::vector<std::size_t> lookups(lookups_n);
+  for (auto &key : lookups) { key = entries[rng() % n].first; }
+
+  std::printf("%zu entries, %zu random lookups, find_batch chunks of %zu\n", n, lookups_n, lookup_chunk);
+  std::printf("%-10s %14s %14s %14s %14s %11s\n",
+    "table",
+    "insert ns",
+    "bulk ns",
+    "find ns",
+    "batch ns",
+    "speedup");
+  run<flat_hashtable<std::size_t, std::size_t>>("flat", entries, lookups);
+  run<hashtable<std::size_t, std::size_t>>("chained", entries, lookups);
+}
@@ -0,0 +1,87 @@
+#include "flat_hashtable.hpp"
+#include "hashtable.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Compares the default hashtable_hash against plain std::hash on a few key patterns that trip up weak hashes:
+ * sequential and strided integers, random integers, and short similar strings. For each it prints the probe
+ * statistics of a flat_hashtable and a chained hashtable filled with the keys, and the time per successful lookup.
+ *
+ * usage: ./bench_hash_distribution [number of keys, default 1000000] [file with one string key per line]
+ */
+
+using clock_type = std::chrono::steady_clock;
+
+static volatile std::size_t sink;
+
+struct std_hash {
+  template<typename T> std::size_t operator()(const T &key) const { return std::hash<T>{}(key); }
+};
+
+template<typename Table, typename Key>
+void run(const char *pattern, const char *hash, const char *name, const std::vector<Key> &keys) {
+  Table table;
+  table.reserve(keys.size());
+  for (const Key &key : keys) { table.insert_or_assign(key, 1); }
+
+  auto start = clock_type::now();
+  std::size_t sum = 0;
+  for (const Key &key : keys) { sum += table.at(key); }
+  sink = sum;
+  double ns = std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+
+  hashtable_stats stats = table.probe_stats();
+  std::printf("%-12s %-14s %-8s %10.1f%% %10.3f %10zu %10.1f\n",
+    pattern,
+    hash,
+    name,
+    100.0 * static_cast<double>(stats.collisions) / static_cast<double>(stats.size),
+    stats.mean_probe_length,
+    stats.max_probe_length,
+    ns / static_cast<double>(keys.size()));
+}
+
+template<typename Key> void compare(const char *pattern, const std::vector<Key> &keys) {
+  run<flat_hashtable<Key, int, hashtable_hash>>(pattern, "hashtable_hash", "flat", keys);
+  run<flat_hashtable<Key, int, std_hash>>(pattern, "std::hash", "flat", keys);
+  run<hashtable<Key, int, hashtable_hash>>(pattern, "hashtable_hash", "chained", keys);
+  run<hashtable<Key, int, std_hash>>(pattern, "std::hash", "chained", keys);
+}
+
+int main(int argc, char **argv) {
+  std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+  std::vector<std::uint64_t> ints(n);
+  std::printf("%-12s %-14s %-8s %11s %10s %10s %10s\n",
+    "keys",
+    "hash",
+    "table",
+    "collided",
+    "mean probe",
+    "max probe",
+    "lookup ns");
+  for (std::size_t i = 0; i < n; ++i) { ints[i] = i; }
+  compare("sequential", ints);
+  for (std::size_t i = 0; i < n; ++i) { ints[i] = i << 12; }
+  compare("stride 4096", ints);
+  std::mt19937_64 rng(42);
+  for (auto &k : ints) { k = rng(); }
+  compare("random", ints);
+
+  std::vector<std::string> strings(n);
+  for (std::size_t i = 0; i < n; ++i) { strings[i] = "user:" + std::to_string(i); }
+  compare("user:N", strings);
+
+  if (argc > 2) {
+    std::ifstream in(argv[2]);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) { lines.push_back(line); }
+    compare("file", lines);
+  }
+}
@@ -0,0 +1,63 @@
+#include "flat_hashtable.hpp"
+#include "hashtable.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/**
+ * Compares the chained hashtable against flat_hashtable at a range of load factors.
+ *
+ * Both tables are given the same fixed bucket count up front so that each row is measured at exactly the requested
+ * load, without any rehashing during the inserts.
+ *
+ * usage: ./bench_hashtable [log2 bucket count, default 16]
+ */
+
+using clock_type = std::chrono::steady_clock;
+
+static volatile std::size_t sink;
+
+template<typename F> double ns_per_op(std::size_t ops, F &&f) {
+  auto start = clock_type::now();
+  f();
+  auto elapsed = std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+  return elapsed / static_cast<double>(ops);
+}
+
+template<typename Table>
+void run(const char *name, Table table, const std::vector<std::size_t> &keys, const std::vector<std::size_t> &misses) {
+  double insert = ns_per_op(keys.size(), [&] {
+    for (std::size_t k : keys) { table.insert(std::size_t(k), std::size_t(k)); }
+  });
+  double hit = ns_per_op(keys.size(), [&] {
+    std::size_t sum = 0;
+    for (std::size_t k : keys) { sum += table[std::size_t(k)]; }
+    sink = sum;
+  });
+  double miss = ns_per_op(misses.size(), [&] {
+    std::size_t found = 0;
+    for (std::size_t k : misses) { found += table.contains(std::size_t(k)); }
+    sink = found;
+  });
+  std::printf("%-16s %10.3f %12.1f %12.1f %12.1f\n", name, static_cast<double>(table.load_factor()), insert, hit, miss);
+}
+
+int main(int argc, char **argv) {
+  std::size_t log2_capacity = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16;
+  std::size_t capacity = std::size_t{ 1 } << log2_capacity;
+
+  std::mt19937_64 rng(42);
+  std::printf("%-16s %10s %12s %12s %12s\n", "table", "load", "insert ns", "hit ns", "miss ns");
+  for (float target : { 0.25F, 0.5F, 0.75F, 0.875F }) {
+    auto n = static_cast<std::size_t>(target * static_cast<float>(capacity));
+    std::vector<std::size_t> keys(n);
+    std::vector<std::size_t> misses(n);
+    for (auto &k : keys) { k = rng(); }
+    for (auto &k : misses) { k = rng(); }
+
+    run("chained", hashtable<std::size_t, std::size_t>(capacity), keys, misses);
+    run("flat", flat_hashtable<std::size_t, std::size_t>(capacity), keys, misses);
+  }
+}
@@ -0,0 +1,57 @@
+#include "flat_hashtable.hpp"
+#include "hashtable.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+/**
+ * Iterates over full tables and counts how many heap allocations happen while doing so, by replacing the global
+ * operator new. Both the chained and the flat table should report zero.
+ *
+ * usage: ./bench_iteration [number of entries, default 1048576]
+ */
+
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t n) {
+  ++allocations;
+  if (void *p = std::malloc(n)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+using clock_type = std::chrono::steady_clock;
+
+template<typename Table> void run(const char *name, Table &table) {
+  std::size_t before = allocations;
+  auto start = clock_type::now();
+  std::size_t sum = 0;
+  std::size_t count = 0;
+  for (const auto &[key, value] : table) {
+    sum += value;
+    ++count;
+  }
+  auto elapsed = std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+  std::printf("%-10s %10zu entries %8.2f ns/entry %6zu allocations (checksum %zu)\n",
+    name,
+    count,
+    elapsed / static_cast<double>(count),
+    allocations - before,
+    sum);
+}
+
+int main(int argc, char **argv) {
+  std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::size_t{ 1 } << 20;
+  hashtable<std::size_t, std::size_t> chained;
+  flat_hashtable<std::size_t, std::size_t> flat;
+  for (std::size_t i = 0; i < n; ++i) {
+    chained.insert(std::size_t(i), std::size_t(i));
+    flat.insert(std::size_t(i), std::size_t(i));
+  }
+  run("chained", chained);
+  run("flat", flat);
+}
@@ -0,0 +1,117 @@
+#include "flat_hashtable.hpp"
+#include "hashset.hpp"
+#include "hashtable.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Memory footprint per element of a set of 64 bit integers kept three ways: the chained hashtable with a dummy char
+ * value, flat_hashtable with the same dummy value, and hashset. Live heap bytes are tracked by replacing the global
+ * operator new, using malloc_usable_size so that allocator rounding is included.
+ *
+ * Sizes whose estimated footprint does not fit in the available memory are not built. Their bytes per element are
+ * extrapolated from the per-bucket and per-entry cost measured at the previous size instead, and marked as such.
+ *
+ * usage: ./bench_memory [number of entries...] (default 1000000 100000000)
+ */
+
+static std::size_t live_bytes = 0;
+
+void *operator new(std::size_t n) {
+  if (void *p = std::malloc(n)) {
+    live_bytes += malloc_usable_size(p);
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+  if (p) { live_bytes -= malloc_usable_size(p); }
+  std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept { operator delete(p); }
+
+std::size_t available_memory() {
+  return static_cast<std::size_t>(sysconf(_SC_AVPHYS_PAGES)) * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+/**
+ * Footprint of a table split into what every bucket costs and what each entry costs on top of that, measured on the
+ * last size that was actually built and used to extrapolate to sizes that are not.
+ */
+struct footprint {
+  double per_bucket{};
+  double per_entry{};
+  float max_load{};
+
+  bool measured() const { return max_load > 0; }
+
+  double bytes(std::size_t n) const {
+    std::size_t buckets = 16;
+    while (static_cast<double>(buckets) * static_cast<double>(max_load) < static_cast<double>(n)) { buckets *= 2; }
+    return per_bucket * static_cast<double>(buckets) + per_entry * static_cast<double>(n);
+  }
+};
+
+template<typename Table, typename Insert>
+footprint measure(const char *name, std::size_t n, footprint model, Insert insert) {
+  // leave headroom for the old bucket array that is still alive while the table doubles
+  if (model.measured() && model.bytes(n) * 1.5 > static_cast<double>(available_memory())) {
+    std::printf("%-26s %12zu %14.2f   (extrapolated, needs about %.1f GB)\n",
+      name,
+      n,
+      model.bytes(n) / static_cast<double>(n),
+      model.bytes(n) / 1e9);
+    return model;
+  }
+  std::size_t before = live_bytes;
+  std::size_t total = 0;
+  std::size_t buckets = 0;
+  {
+    Table table;
+    for (std::uint64_t i = 0; i < n; ++i) { insert(table, i * 0x9E3779B97F4A7C15ULL); }
+    total = live_bytes - before;
+    buckets = table.bucket_count();
+    model.max_load = table.max_load_factor();
+  }
+  {
+    Table empty;
+    before = live_bytes;
+    empty.rehash(buckets);
+    model.per_bucket = static_cast<double>(live_bytes - before) / static_cast<double>(buckets);
+  }
+  model.per_entry =
+    (static_cast<double>(total) - model.per_bucket * static_cast<double>(buckets)) / static_cast<double>(n);
+  std::printf("%-26s %12zu %14.2f   (%zu buckets at %.2f bytes, %.2f bytes per entry on top)\n",
+    name,
+    n,
+    static_cast<double>(total) / static_cast<double>(n),
+    buckets,
+    model.per_bucket,
+    model.per_entry);
+  return model;
+}
+
+int main(int argc, char **argv) {
+  std::vector<std::size_t> sizes;
+  for (int i = 1; i < argc; ++i) { sizes.push_back(std::strtoul(argv[i], nullptr, 10)); }
+  if (sizes.empty()) { sizes = { 1000000, 100000000 }; }
+
+  std::printf("%-26s %12s %14s\n", "container", "entries", "bytes/element");
+  footprint chained;
+  footprint flat;
+  footprint set;
+  for (std::size_t n : sizes) {
+    chained = measure<hashtable<std::uint64_t, char>>(
+      "hashtable<u64, char>", n, chained, [](auto &t, auto k) { t.insert(std::uint64_t(k), char(0)); });
+    flat = measure<flat_hashtable<std::uint64_t, char>>(
+      "flat_hashtable<u64, char>", n, flat, [](auto &t, auto k) { t.insert(std::uint64_t(k), char(0)); });
+    set = measure<hashset<std::uint64_t>>("hashset<u64>", n, set, [](auto &t, auto k) { t.insert(k); });
+  }
+}
@@ -0,0 +1,75 @@
+#include "flat_hashtable.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/**
+ * Positive and negative lookups on flat_hashtable at a range of sizes, filled to just under the maximum load so that
+ * probes are as long as they get. Build it twice to compare the SSE2 group match against the scalar fallback:
+ *
+ *   make bench_probe && ./bench_probe
+ *   make bench_probe_scalar && ./bench_probe_scalar
+ *
+ * usage: ./bench_probe [log2 largest table, default 22]
+ */
+
+using clock_type = std::chrono::steady_clock;
+
+static volatile std::size_t sink;
+
+template<typename F> double ns_per_op(std::size_t ops, F &&f) {
+  auto start = clock_type::now();
+  f();
+  auto elapsed = std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+  return elapsed / static_cast<double>(ops);
+}
+
+int main(int argc, char **argv) {
+  std::size_t max_log2 = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 22;
+#ifdef FLAT_HASHTABLE_SSE2
+  std::printf("group match: sse2\n");
+#else
+  std::printf("group match: scalar\n");
+#endif
+  std::printf("%10s %8s %12s %12s %14s %14s\n", "capacity", "load", "hit ns", "miss ns", "90% hit ns", "10% hit ns");
+
+  std::mt19937_64 rng(1);
+  for (std::size_t log2 = 10; log2 <= max_log2; log2 += 2) {
+    std::size_t capacity = std::size_t{ 1 } << log2;
+    std::size_t n = capacity - capacity / 8 - 1;
+    flat_hashtable<std::size_t, std::size_t> table(capacity);
+    std::vector<std::size_t> keys(n);
+    std::vector<std::size_t> misses(n);
+    for (auto &k : keys) {
+      k = rng();
+      table.insert(k, k);
+    }
+    for (auto &k : misses) { k = rng(); }
+    std::shuffle(keys.begin(), keys.end(), rng);
+
+    auto lookups = [&](std::size_t hit_percent) {
+      return ns_per_op(n, [&] {
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+          std::size_t key = (i % 100) < hit_percent ? keys[i] : misses[i];
+          found += table.contains(key);
+        }
+        sink = found;
+      });
+    };
+    double hit = lookups(100);
+    double miss = lookups(0);
+    double mostly_hit = lookups(90);
+    double mostly_miss = lookups(10);
+    std::printf("%10zu %8.3f %12.1f %12.1f %14.1f %14.1f\n",
+      table.bucket_count(),
+      static_cast<double>(table.load_factor()),
+      hit,
+      miss,
+      mostly_hit,
+      mostly_miss);
+  }
+}
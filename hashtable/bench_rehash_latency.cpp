@@ -0,0 +1,56 @@
+#include "hashtable.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/**
+ * Times every single insert into a growing hashtable, once with stop-the-world rehashing and once with incremental
+ * rehashing, and prints a latency histogram with power-of-two nanosecond buckets plus the tail percentiles.
+ *
+ * usage: ./bench_rehash_latency [number of inserts, default 4194304]
+ */
+
+using clock_type = std::chrono::steady_clock;
+
+std::vector<std::uint64_t> time_inserts(std::size_t n, bool incremental) {
+  hashtable<std::size_t, std::size_t> table;
+  table.incremental_rehash(incremental);
+  std::vector<std::uint64_t> samples(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    auto start = clock_type::now();
+    table.insert(std::size_t(i), std::size_t(i));
+    samples[i] = static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - start).count());
+  }
+  return samples;
+}
+
+void report(const char *name, std::vector<std::uint64_t> samples) {
+  std::vector<std::size_t> histogram(64);
+  for (std::uint64_t ns : samples) { ++histogram[static_cast<std::size_t>(std::bit_width(ns))]; }
+  std::sort(samples.begin(), samples.end());
+  auto percentile = [&samples](double p) {
+    return samples[static_cast<std::size_t>(p * static_cast<double>(samples.size() - 1))];
+  };
+
+  std::printf("%s\n", name);
+  std::printf("  p50 %lu ns, p99 %lu ns, p99.9 %lu ns, p99.99 %lu ns, max %lu ns\n",
+    percentile(0.5),
+    percentile(0.99),
+    percentile(0.999),
+    percentile(0.9999),
+    samples.back());
+  for (std::size_t b = 0; b < histogram.size(); ++b) {
+    if (histogram[b] == 0) continue;
+    std::printf("  < %12lu ns: %zu\n", std::uint64_t{ 1 } << b, histogram[b]);
+  }
+}
+
+int main(int argc, char **argv) {
+  std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::size_t{ 1 } << 22;
+  report("stop-the-world rehash", time_inserts(n, false));
+  report("incremental rehash", time_inserts(n, true));
+}
@@ -0,0 +1,165 @@
+#ifndef CONCURRENT_HASHTABLE_HPP
+#define CONCURRENT_HASHTABLE_HPP
+
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+
+#include "hashtable.hpp"
+
+#define DEFAULT_SHARD_COUNT 64
+
+/**
+ * Hashtable which can be shared between threads.
+ *
+ * Keys are spread over Shards independent hashtables, each guarded by its own reader-writer lock, so threads working
+ * on different shards never wait on each other and lookups within a shard only take a shared lock. The shard is
+ * picked from the high bits of the same mixed hash whose low bits pick the bucket inside the shard.
+ *
+ * Hash and KeyEqual are passed on to the shards' hashtables.
+ *
+ * Nothing hands out references or iterators into a shard, since those would outlive the lock. Lookups copy the value
+ * out, and for_each_shard runs a callback while the shard's lock is held.
+ */
+template<typename Key,
+  typename Value,
+  std::size_t Shards = DEFAULT_SHARD_COUNT,
+  hasher_for<Key> Hash = hashtable_hash,
+  std::predicate<const Key &, const Key &> KeyEqual = hashtable_equal>
+class concurrent_hashtable {
+  static_assert(std::has_single_bit(Shards), "shard count must be a power of two");
+
+public:
+  using table_type = hashtable<Key, Value, Hash, KeyEqual>;
+
+private:
+  // each shard gets its own cache line(s) so that locking one does not bounce its neighbours
+  struct alignas(64) shard {
+    mutable std::shared_mutex lock;
+    table_type table;
+  };
+
+  std::unique_ptr<shard[]> shards;
+  [[no_unique_address]] Hash hasher;
+
+  template<typename K> shard &shard_for(const K &key) const {
+    std::size_t h = hashtable_mix(hasher(key));
+    return shards[(h >> 40) & (Shards - 1)];
+  }
+
+  template<typename K> std::optional<Value> find_impl(const K &key) const {
+    shard &s = shard_for(key);
+    std::shared_lock guard(s.lock);
+    // the const overloads never migrate buckets, so they are safe under a shared lock
+    const table_type &table = s.table;
+    auto it = table.find(key);
+    if (it == table.end()) return std::nullopt;
+    return it->second;
+  }
+
+  template<typename K> bool erase_impl(const K &key) {
+    shard &s = shard_for(key);
+    std::unique_lock guard(s.lock);
+    if (!s.table.contains(key)) return false;
+    s.table.erase(key);
+    return true;
+  }
+
+public:
+  concurrent_hashtable() : shards(std::make_unique<shard[]>(Shards)) {}
+
+  /**
+   * Starts every shard with enough buckets for its share of bucket_count.
+   */
+  explicit concurrent_hashtable(std::size_t bucket_count, const Hash &hash = Hash(), const KeyEqual &equal = KeyEqual())
+    : shards(std::make_unique<shard[]>(Shards)), hasher(hash) {
+    for (std::size_t i = 0; i < Shards; ++i) { shards[i].table = table_type(bucket_count / Shards, hash, equal); }
+  }
+
+  concurrent_hashtable(const concurrent_hashtable &) = delete;
+
+  concurrent_hashtable &operator=(const concurrent_hashtable &) = delete;
+
+  /**
+   * Inserts the pair if key is not present yet. Returns whether it was inserted.
+   */
+  bool insert(const Key &key, const Value &value) {
+    shard &s = shard_for(key);
+    std::unique_lock guard(s.lock);
+    return s.table.insert(key, value).second;
+  }
+
+  bool insert(Key &&key, Value &&value) {
+    shard &s = shard_for(key);
+    std::unique_lock guard(s.lock);
+    return s.table.insert(std::move(key), std::move(value)).second;
+  }
+
+  /**
+   * Inserts the pair, or assigns value over the existing one. Returns whether it was inserted.
+   */
+  template<typename M> bool insert_or_assign(const Key &key, M &&value) {
+    shard &s = shard_for(key);
+    std::unique_lock guard(s.lock);
+    return s.table.insert_or_assign(key, std::forward<M>(value)).second;
+  }
+
+  /**
+   * Removes key if present. Returns whether anything was removed, rather than throwing like hashtable::erase, since
+   * another thread may have removed the key between a caller's check and this call.
+   */
+  bool erase(const Key &key) { return erase_impl(key); }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> bool erase(const K &key) { return erase_impl(key); }
+
+  bool contains(const Key &key) const {
+    shard &s = shard_for(key);
+    std::shared_lock guard(s.lock);
+    return std::as_const(s.table).contains(key);
+  }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> bool contains(const K &key) const {
+    shard &s = shard_for(key);
+    std::shared_lock guard(s.lock);
+    return std::as_const(s.table).contains(key);
+  }
+
+  /**
+   * Returns a copy of the value stored for key, if there is one.
+   */
+  std::optional<Value> find(const Key &key) const { return find_impl(key); }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> std::optional<Value> find(const K &key) const {
+    return find_impl(key);
+  }
+
+  /**
+   * Calls f(const table_type &) on each shard in turn while holding that shard's shared lock. Shards are
+   * locked one at a time, so the scan as a whole is not a consistent snapshot.
+   */
+  template<typename F> void for_each_shard(F &&f) const {
+    for (std::size_t i = 0; i < Shards; ++i) {
+      std::shared_lock guard(shards[i].lock);
+      f(std::as_const(shards[i].table));
+    }
+  }
+
+  /**
+   * Total number of entries. Like for_each_shard this is only exact if no other thread is writing.
+   */
+  std::size_t size() const {
+    std::size_t total = 0;
+    for_each_shard([&total](const table_type &table) { total += table.size(); });
+    return total;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  static constexpr std::size_t shard_count() { return Shards; }
+};
+
+#endif // !CONCURRENT_HASHTABLE_HPP
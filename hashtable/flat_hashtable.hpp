@@ -0,0 +1,662 @@
+#ifndef FLAT_HASHTABLE_HPP
+#define FLAT_HASHTABLE_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) && !defined(FLAT_HASHTABLE_NO_SIMD)
+#include <emmintrin.h>
+#define FLAT_HASHTABLE_SSE2
+#endif
+
+#include "hashtable.hpp"
+
+using ctrl_t = signed char;
+
+/**
+ * Control byte values. Any non-negative control byte marks a full slot and holds the low 7 bits of the key's hash,
+ * so a slot is free exactly when its control byte is negative.
+ */
+enum flat_ctrl : ctrl_t { ctrl_empty = -128, ctrl_deleted = -2 };
+
+/**
+ * A window of width control bytes which is matched against a value all at once. Bit i of each returned mask is set
+ * when byte i matched. With SSE2 a match is a single compare plus movemask, otherwise (or when FLAT_HASHTABLE_NO_SIMD
+ * is defined) it falls back to a loop over the bytes.
+ */
+struct ctrl_group {
+  static constexpr std::size_t width = 16;
+
+#ifdef FLAT_HASHTABLE_SSE2
+  __m128i bytes;
+
+  explicit ctrl_group(const ctrl_t *pos) : bytes(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos))) {}
+
+  std::uint32_t match(ctrl_t h) const {
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h), bytes)));
+  }
+
+  // free slots are exactly the bytes with the sign bit set, which is what movemask collects
+  std::uint32_t match_empty_or_deleted() const { return static_cast<std::uint32_t>(_mm_movemask_epi8(bytes)); }
+#else
+  ctrl_t bytes[width];
+
+  explicit ctrl_group(const ctrl_t *pos) { std::memcpy(bytes, pos, width); }
+
+  std::uint32_t match(ctrl_t h) const {
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < width; ++i) { mask |= static_cast<std::uint32_t>(bytes[i] == h) << i; }
+    return mask;
+  }
+
+  std::uint32_t match_empty_or_deleted() const {
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < width; ++i) { mask |= static_cast<std::uint32_t>(bytes[i] < 0) << i; }
+    return mask;
+  }
+#endif
+
+  std::uint32_t match_empty() const { return match(ctrl_empty); }
+};
+
+template<typename Slot, bool Const> class flat_hashtableIterator;
+
+/**
+ * Open addressing engine shared by flat_hashtable and hashset. It stores Slots, which are either a Key on its own or
+ * a pair whose first member is the Key, and implements everything that does not care which of the two it is.
+ *
+ * Entries live in one contiguous slot array next to a parallel array of control bytes. A lookup probes the control
+ * bytes a ctrl_group at a time, triangularly from group to group, and only compares keys whose 7 bit hash tag
+ * matches, so the common case touches one cache line of metadata and one slot instead of a bucket vector, a list node
+ * and the pair it owns.
+ *
+ * The first ctrl_group::width - 1 control bytes are cloned after the last one, so a group starting near the end of
+ * the table can be loaded in one go and still sees the slots it wraps around to.
+ *
+ * The capacity is always a power of two and the table grows once it is 7/8 full.
+ */
+template<typename Key, typename Slot, hasher_for<Key> Hash, std::predicate<const Key &, const Key &> KeyEqual>
+class flat_table {
+  // the keys of a set are its whole slot, so they are never handed out mutable
+  static constexpr bool is_set = std::same_as<Slot, Key>;
+
+public:
+  using iterator = flat_hashtableIterator<Slot, is_set>;
+  using const_iterator = flat_hashtableIterator<Slot, true>;
+
+protected:
+  using slot_type = Slot;
+
+  // has to be at least ctrl_group::width so that every cloned control byte mirrors a distinct slot
+  static constexpr std::size_t initial_capacity = ctrl_group::width;
+
+  float loadfactor{ 0.875F };
+  std::unique_ptr<ctrl_t[]> ctrl;
+  slot_type *slots{};
+  std::size_t capacity{};
+  std::size_t _size{};
+  std::size_t growth_left{};
+  [[no_unique_address]] Hash hasher;
+  [[no_unique_address]] KeyEqual key_equal;
+
+  template<typename K> std::size_t hash(const K &key) const { return hashtable_mix(hasher(key)); }
+
+  static const Key &key_of(const slot_type &slot) {
+    if constexpr (is_set) {
+      return slot;
+    } else {
+      return slot.first;
+    }
+  }
+
+  /**
+   * Builds a slot from key alone for a set, or from key and the value's constructor arguments for a map.
+   */
+  template<typename K, typename... Args> static void construct_slot(slot_type *slot, K &&key, Args &&...args) {
+    if constexpr (is_set) {
+      static_assert(sizeof...(Args) == 0, "a set slot holds nothing but the key");
+      std::construct_at(slot, std::forward<K>(key));
+    } else {
+      std::construct_at(slot,
+        std::piecewise_construct,
+        std::forward_as_tuple(std::forward<K>(key)),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+  }
+
+  static std::size_t h1(std::size_t hash) { return hash >> 7; }
+
+  static ctrl_t h2(std::size_t hash) { return static_cast<ctrl_t>(hash & 0x7F); }
+
+  // always leave at least one empty slot so that every probe sequence terminates
+  std::size_t max_size_for(std::size_t cap) const {
+    return std::min(cap - 1, static_cast<std::size_t>(static_cast<float>(cap) * loadfactor));
+  }
+
+  std::size_t capacity_for(std::size_t n) const {
+    std::size_t cap = initial_capacity;
+    while (max_size_for(cap) < n) { cap *= 2; }
+    return cap;
+  }
+
+  static std::size_t num_ctrl_bytes(std::size_t cap) { return cap + ctrl_group::width - 1; }
+
+  void initialize(std::size_t cap) {
+    ctrl = std::make_unique<ctrl_t[]>(num_ctrl_bytes(cap));
+    std::fill(ctrl.get(), ctrl.get() + num_ctrl_bytes(cap), ctrl_empty);
+    slots = std::allocator<slot_type>{}.allocate(cap);
+    capacity = cap;
+    growth_left = max_size_for(cap) - _size;
+  }
+
+  void destroy_slots() {
+    if (!slots) return;
+    for (std::size_t i = 0; i < capacity; ++i) {
+      if (ctrl[i] >= 0) { std::destroy_at(slots + i); }
+    }
+    std::allocator<slot_type>{}.deallocate(slots, capacity);
+    slots = nullptr;
+  }
+
+  /**
+   * Sets the control byte of slot pos, along with its clone past the end if it has one.
+   */
+  void set_ctrl(std::size_t pos, ctrl_t value) {
+    ctrl[pos] = value;
+    if (pos < ctrl_group::width - 1) { ctrl[capacity + pos] = value; }
+  }
+
+  template<typename K> std::size_t find_index(const K &key) const {
+    if (_size == 0) return capacity;
+    return find_index(key, hash(key));
+  }
+
+  template<typename K> std::size_t find_index(const K &key, std::size_t h) const {
+    std::size_t mask = capacity - 1;
+    std::size_t pos = h1(h) & mask;
+    for (std::size_t step = ctrl_group::width;; pos = (pos + step) & mask, step += ctrl_group::width) {
+      ctrl_group group(ctrl.get() + pos);
+      for (std::uint32_t match = group.match(h2(h)); match; match &= match - 1) {
+        std::size_t idx = (pos + static_cast<std::size_t>(std::countr_zero(match))) & mask;
+        if (key_equal(key_of(slots[idx]), key)) return idx;
+      }
+      if (group.match_empty()) return capacity;
+    }
+  }
+
+  std::size_t find_first_non_full(std::size_t hash) const {
+    std::size_t mask = capacity - 1;
+    std::size_t pos = h1(hash) & mask;
+    for (std::size_t step = ctrl_group::width;; pos = (pos + step) & mask, step += ctrl_group::width) {
+      std::uint32_t free = ctrl_group(ctrl.get() + pos).match_empty_or_deleted();
+      if (free) return (pos + static_cast<std::size_t>(std::countr_zero(free))) & mask;
+    }
+  }
+
+  /**
+   * Returns the slot holding key, or the slot key should be inserted into along with false. Grows the table first
+   * if claiming a fresh empty slot would push it over the maximum load.
+   */
+  template<typename K> std::pair<std::size_t, bool> find_or_prepare_insert(const K &key, std::size_t h) {
+    if (capacity == 0) { grow(); }
+    while (true) {
+      std::size_t mask = capacity - 1;
+      std::size_t target = capacity;
+      std::size_t pos = h1(h) & mask;
+      for (std::size_t step = ctrl_group::width;; pos = (pos + step) & mask, step += ctrl_group::width) {
+        ctrl_group group(ctrl.get() + pos);
+        for (std::uint32_t match = group.match(h2(h)); match; match &= match - 1) {
+          std::size_t idx = (pos + static_cast<std::size_t>(std::countr_zero(match))) & mask;
+          if (key_equal(key_of(slots[idx]), key)) return { idx, true };
+        }
+        std::uint32_t free = group.match_empty_or_deleted();
+        if (target == capacity && free) { target = (pos + static_cast<std::size_t>(std::countr_zero(free))) & mask; }
+        if (group.match_empty()) break;
+      }
+      // reusing a tombstone is always fine, claiming an empty slot needs room under the maximum load
+      if (ctrl[target] == ctrl_deleted || growth_left > 0) return { target, false };
+      grow();
+    }
+  }
+
+  void grow() {
+    if (capacity == 0) {
+      resize(initial_capacity);
+    } else if (_size * 2 < max_size_for(capacity)) {
+      // mostly tombstones, so rehashing at the same capacity is enough to free up slots
+      resize(capacity);
+    } else {
+      resize(capacity * 2);
+    }
+  }
+
+  void resize(std::size_t new_capacity) {
+    std::unique_ptr<ctrl_t[]> old_ctrl = std::move(ctrl);
+    slot_type *old_slots = slots;
+    std::size_t old_capacity = capacity;
+    initialize(new_capacity);
+    for (std::size_t i = 0; i < old_capacity; ++i) {
+      if (old_ctrl[i] < 0) continue;
+      std::size_t h = hash(key_of(old_slots[i]));
+      std::size_t pos = find_first_non_full(h);
+      std::construct_at(slots + pos, std::move(old_slots[i]));
+      std::destroy_at(old_slots + i);
+      set_ctrl(pos, h2(h));
+    }
+    if (old_slots) { std::allocator<slot_type>{}.deallocate(old_slots, old_capacity); }
+  }
+
+  void occupy(std::size_t pos, std::size_t h) {
+    if (ctrl[pos] == ctrl_empty) { --growth_left; }
+    set_ctrl(pos, h2(h));
+    ++_size;
+  }
+
+  template<typename K, typename... Args> std::pair<iterator, bool> try_emplace_impl(K &&key, Args &&...args) {
+    std::size_t h = hash(key);
+    auto [pos, found] = find_or_prepare_insert(key, h);
+    if (!found) {
+      construct_slot(slots + pos, std::forward<K>(key), std::forward<Args>(args)...);
+      occupy(pos, h);
+    }
+    return { iterator(ctrl.get() + pos, slots + pos, ctrl.get() + capacity), !found };
+  }
+
+  /**
+   * Looks keys up FIND_BATCH_SIZE at a time: hash every key of the batch and prefetch its first control group and home
+   * slot, then probe. The cache misses of a whole batch overlap instead of being paid one key after another.
+   */
+  template<typename Iterator, typename Keys, typename Out> Out find_batch_impl(const Keys &keys, Out out) const {
+    using difference = std::ranges::range_difference_t<const Keys>;
+    auto first = std::ranges::begin(keys);
+    auto n = static_cast<std::size_t>(std::ranges::distance(keys));
+    std::size_t mask = capacity - 1;
+    std::array<std::size_t, FIND_BATCH_SIZE> hashes;
+    for (std::size_t start = 0; start < n; start += FIND_BATCH_SIZE) {
+      std::size_t count = std::min<std::size_t>(FIND_BATCH_SIZE, n - start);
+      auto batch = first + static_cast<difference>(start);
+      if (_size != 0) {
+        for (std::size_t i = 0; i < count; ++i) {
+          hashes[i] = hash(batch[static_cast<difference>(i)]);
+          hashtable_prefetch(ctrl.get() + (h1(hashes[i]) & mask));
+          hashtable_prefetch(slots + (h1(hashes[i]) & mask));
+        }
+      }
+      for (std::size_t i = 0; i < count; ++i) {
+        std::size_t pos = _size == 0 ? capacity : find_index(batch[static_cast<difference>(i)], hashes[i]);
+        *out++ = Iterator(ctrl.get() + pos, slots + pos, ctrl.get() + capacity);
+      }
+    }
+    return out;
+  }
+
+  template<typename K> void erase_impl(const K &key) {
+    std::size_t pos = find_index(key);
+    if (pos == capacity) { throw std::out_of_range("key does not exist"); }
+    std::destroy_at(slots + pos);
+    --_size;
+    // if every group that covers pos still has an empty slot then no probe ever ran past one of them, so pos can go
+    // straight back to empty instead of leaving a tombstone
+    std::size_t mask = capacity - 1;
+    std::uint32_t empty_after = ctrl_group(ctrl.get() + pos).match_empty();
+    std::uint32_t empty_before = ctrl_group(ctrl.get() + ((pos - ctrl_group::width) & mask)).match_empty();
+    if (empty_after && empty_before
+        && std::countr_zero(empty_after) + std::countl_zero(static_cast<std::uint16_t>(empty_before))
+             < static_cast<int>(ctrl_group::width)) {
+      set_ctrl(pos, ctrl_empty);
+      ++growth_left;
+    } else {
+      set_ctrl(pos, ctrl_deleted);
+    }
+  }
+
+public:
+  flat_table() = default;
+
+  /**
+   * Starts with at least bucket_count slots, rounded up to a power of two.
+   */
+  explicit flat_table(std::size_t bucket_count, const Hash &hash = Hash(), const KeyEqual &equal = KeyEqual())
+    : hasher(hash), key_equal(equal) {
+    initialize(std::bit_ceil(std::max(bucket_count, initial_capacity)));
+  }
+
+  flat_table(const flat_table &other)
+    : loadfactor(other.loadfactor), _size(other._size), hasher(other.hasher), key_equal(other.key_equal) {
+    if (other.capacity == 0) return;
+    initialize(other.capacity);
+    std::copy(other.ctrl.get(), other.ctrl.get() + num_ctrl_bytes(capacity), ctrl.get());
+    for (std::size_t i = 0; i < capacity; ++i) {
+      if (ctrl[i] >= 0) { std::construct_at(slots + i, other.slots[i]); }
+    }
+    growth_left = other.growth_left;
+  }
+
+  flat_table(flat_table &&other) noexcept { swap(other); }
+
+  flat_table &operator=(flat_table other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~flat_table() { destroy_slots(); }
+
+  void swap(flat_table &other) noexcept {
+    std::swap(loadfactor, other.loadfactor);
+    std::swap(ctrl, other.ctrl);
+    std::swap(slots, other.slots);
+    std::swap(capacity, other.capacity);
+    std::swap(_size, other._size);
+    std::swap(growth_left, other.growth_left);
+    std::swap(hasher, other.hasher);
+    std::swap(key_equal, other.key_equal);
+  }
+
+  Hash hash_function() const { return hasher; }
+
+  KeyEqual key_eq() const { return key_equal; }
+
+  iterator find(const Key &key) {
+    std::size_t pos = find_index(key);
+    return pos == capacity ? end() : iterator(ctrl.get() + pos, slots + pos, ctrl.get() + capacity);
+  }
+
+  const_iterator find(const Key &key) const {
+    std::size_t pos = find_index(key);
+    return pos == capacity ? end() : const_iterator(ctrl.get() + pos, slots + pos, ctrl.get() + capacity);
+  }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> iterator find(const K &key) {
+    std::size_t pos = find_index(key);
+    return pos == capacity ? end() : iterator(ctrl.get() + pos, slots + pos, ctrl.get() + capacity);
+  }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> const_iterator find(const K &key) const {
+    std::size_t pos = find_index(key);
+    return pos == capacity ? end() : const_iterator(ctrl.get() + pos, slots + pos, ctrl.get() + capacity);
+  }
+
+  void erase(const Key &key) { erase_impl(key); }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> void erase(const K &key) { erase_impl(key); }
+
+  /**
+   * Looks up every key of keys and writes an iterator to its entry, or end() if it is missing, to out. Returns out
+   * past the last iterator written. Faster than calling find per key on tables that do not fit in cache, since the
+   * memory accesses of up to FIND_BATCH_SIZE keys are in flight at once.
+   */
+  template<std::ranges::random_access_range Keys, std::output_iterator<iterator> Out>
+    requires lookup_key<std::ranges::range_value_t<Keys>, Key, Hash, KeyEqual>
+  Out find_batch(const Keys &keys, Out out) {
+    return find_batch_impl<iterator>(keys, out);
+  }
+
+  template<std::ranges::random_access_range Keys, std::output_iterator<const_iterator> Out>
+    requires lookup_key<std::ranges::range_value_t<Keys>, Key, Hash, KeyEqual>
+  Out find_batch(const Keys &keys, Out out) const {
+    return find_batch_impl<const_iterator>(keys, out);
+  }
+
+  bool contains(const Key &key) const { return find_index(key) != capacity; }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> bool contains(const K &key) const {
+    return find_index(key) != capacity;
+  }
+
+  std::size_t size() const { return _size; }
+
+  bool empty() const { return _size == 0; }
+
+  std::size_t bucket_count() const { return capacity; }
+
+  float load_factor() const { return capacity == 0 ? 0.0F : static_cast<float>(_size) / static_cast<float>(capacity); }
+
+  float max_load_factor() const { return loadfactor; }
+
+  /**
+   * Sets the load factor past which the table grows. It has to stay below 1 since open addressing needs empty
+   * slots to end a probe.
+   */
+  void max_load_factor(float ml) {
+    if (!(ml > 0.0F && ml < 1.0F)) { throw std::invalid_argument("max load factor must be between 0 and 1"); }
+    loadfactor = ml;
+    if (capacity != 0) { resize(std::max(capacity, capacity_for(_size))); }
+  }
+
+  /**
+   * Rebuilds the table with at least n slots, and at least enough slots to stay under the maximum load factor.
+   * This also clears out any tombstones left behind by erase.
+   */
+  void rehash(std::size_t n) {
+    if (n == 0 && _size == 0) {
+      destroy_slots();
+      ctrl.reset();
+      capacity = 0;
+      growth_left = 0;
+      return;
+    }
+    resize(std::max(std::bit_ceil(n), capacity_for(_size)));
+  }
+
+  /**
+   * Makes room for n entries without any further rehashing.
+   */
+  void reserve(std::size_t n) {
+    if (n > max_size_for(capacity)) { resize(capacity_for(n)); }
+  }
+
+  iterator begin() {
+    if (empty()) return end();
+    return iterator(ctrl.get(), slots, ctrl.get() + capacity);
+  }
+
+  iterator end() { return iterator(ctrl.get() + capacity, slots + capacity, ctrl.get() + capacity); }
+
+  const_iterator begin() const {
+    if (empty()) return end();
+    return const_iterator(ctrl.get(), slots, ctrl.get() + capacity);
+  }
+
+  const_iterator end() const {
+    return const_iterator(ctrl.get() + capacity, slots + capacity, ctrl.get() + capacity);
+  }
+
+  const_iterator cbegin() const { return begin(); }
+
+  const_iterator cend() const { return end(); }
+
+  /**
+   * Replays the probe sequence of every entry to report how far from home they ended up. An entry collided if it is
+   * not in its home slot, and its probe length is the number of groups a lookup loads before reaching it.
+   */
+  hashtable_stats probe_stats() const {
+    hashtable_stats stats;
+    stats.size = _size;
+    stats.bucket_count = capacity;
+    std::size_t mask = capacity - 1;
+    for (std::size_t i = 0; i < capacity; ++i) {
+      if (ctrl[i] < 0) continue;
+      std::size_t home = h1(hash(key_of(slots[i]))) & mask;
+      std::size_t pos = home;
+      std::size_t length = 1;
+      for (std::size_t step = ctrl_group::width; ((i - pos) & mask) >= ctrl_group::width; step += ctrl_group::width) {
+        pos = (pos + step) & mask;
+        ++length;
+      }
+      stats.add(length, i != home);
+    }
+    return stats;
+  }
+};
+
+/**
+ * Open addressing Hashtable with the same interface, and the same Hash and KeyEqual parameters, as hashtable. See
+ * flat_table for the layout.
+ */
+template<typename Key,
+  typename Value,
+  hasher_for<Key> Hash = hashtable_hash,
+  std::predicate<const Key &, const Key &> KeyEqual = hashtable_equal>
+class flat_hashtable : public flat_table<Key, std::pair<Key, Value>, Hash, KeyEqual> {
+  using base = flat_table<Key, std::pair<Key, Value>, Hash, KeyEqual>;
+  using base::capacity;
+  using base::find_index;
+  using base::slots;
+  using base::try_emplace_impl;
+
+  template<typename K> Value &at_impl(const K &key) const {
+    std::size_t pos = find_index(key);
+    if (pos == capacity) { throw std::out_of_range("key does not exist"); }
+    return slots[pos].second;
+  }
+
+public:
+  using typename base::const_iterator;
+  using typename base::iterator;
+  using base::base;
+
+  /**
+   * Inserts key with a value built from args, unless key is already present in which case nothing is built.
+   * Returns an iterator to the entry for key and whether it was inserted.
+   */
+  template<typename... Args> std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args) {
+    return try_emplace_impl(key, std::forward<Args>(args)...);
+  }
+
+  template<typename... Args> std::pair<iterator, bool> try_emplace(Key &&key, Args &&...args) {
+    return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+  }
+
+  /**
+   * Inserts the pair if key is not present yet, otherwise leaves the existing value alone.
+   */
+  std::pair<iterator, bool> insert(const Key &key, const Value &value) { return try_emplace_impl(key, value); }
+
+  std::pair<iterator, bool> insert(Key &&key, Value &&value) {
+    return try_emplace_impl(std::move(key), std::move(value));
+  }
+
+  /**
+   * Inserts every (key, value) pair of range whose key is not present yet, like insert, and returns how many were
+   * inserted. If the size of range is known up front the table makes room for all of it at once instead of growing
+   * step by step.
+   */
+  template<entry_range<Key> R> std::size_t insert_bulk(R &&range) {
+    if constexpr (std::ranges::sized_range<R>) { this->reserve(this->size() + static_cast<std::size_t>(std::ranges::size(range))); }
+    std::size_t inserted = 0;
+    for (auto &&entry : range) {
+      using entry_type = decltype(entry);
+      inserted += try_emplace_impl(std::get<0>(std::forward<entry_type>(entry)),
+        std::get<1>(std::forward<entry_type>(entry)))
+                    .second;
+    }
+    return inserted;
+  }
+
+  /**
+   * Inserts the pair, or assigns value over the existing one if key is already present.
+   */
+  template<typename M> std::pair<iterator, bool> insert_or_assign(const Key &key, M &&value) {
+    auto ret = try_emplace_impl(key, std::forward<M>(value));
+    if (!ret.second) { ret.first->second = std::forward<M>(value); }
+    return ret;
+  }
+
+  template<typename M> std::pair<iterator, bool> insert_or_assign(Key &&key, M &&value) {
+    auto ret = try_emplace_impl(std::move(key), std::forward<M>(value));
+    if (!ret.second) { ret.first->second = std::forward<M>(value); }
+    return ret;
+  }
+
+  /**
+   * Returns a reference to the value stored for key, throwing std::out_of_range if there is none.
+   */
+  Value &at(const Key &key) { return at_impl(key); }
+
+  const Value &at(const Key &key) const { return at_impl(key); }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> Value &at(const K &key) { return at_impl(key); }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> const Value &at(const K &key) const { return at_impl(key); }
+
+  /**
+   * Same as at(). Unlike std::unordered_map this never inserts a default constructed value for a missing key.
+   */
+  Value &operator[](const Key &key) { return at_impl(key); }
+
+  const Value &operator[](const Key &key) const { return at_impl(key); }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> Value &operator[](const K &key) { return at_impl(key); }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> const Value &operator[](const K &key) const { return at_impl(key); }
+};
+
+template<typename Slot, bool Const> class flat_hashtableIterator {
+  using slot_type = std::conditional_t<Const, const Slot, Slot>;
+  const ctrl_t *m_ctrl{};
+  slot_type *m_slot{};
+  // control byte one past the last slot; the cloned bytes after it are not slots of their own
+  const ctrl_t *m_end{};
+
+  friend class flat_hashtableIterator<Slot, !Const>;
+
+  void skip_empty_slots() {
+    while (m_ctrl != m_end && *m_ctrl < 0) {
+      ++m_ctrl;
+      ++m_slot;
+    }
+  }
+
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = Slot;
+  using difference_type = std::ptrdiff_t;
+  using pointer = slot_type *;
+  using reference = slot_type &;
+
+  flat_hashtableIterator() = default;
+
+  flat_hashtableIterator(const ctrl_t *ctrl, slot_type *slot, const ctrl_t *end)
+    : m_ctrl(ctrl), m_slot(slot), m_end(end) {
+    skip_empty_slots();
+  }
+
+  template<bool OtherConst>
+    requires(Const && !OtherConst)
+  flat_hashtableIterator(const flat_hashtableIterator<Slot, OtherConst> &other)
+    : m_ctrl(other.m_ctrl), m_slot(other.m_slot), m_end(other.m_end) {}
+
+  flat_hashtableIterator &operator++() {
+    ++m_ctrl;
+    ++m_slot;
+    skip_empty_slots();
+    return *this;
+  }
+
+  flat_hashtableIterator operator++(int) {
+    flat_hashtableIterator ret = *this;
+    ++*this;
+    return ret;
+  }
+
+  bool operator==(const flat_hashtableIterator &other) const { return m_ctrl == other.m_ctrl; }
+
+  bool operator!=(const flat_hashtableIterator &other) const { return !(*this == other); }
+
+  reference operator*() const { return *m_slot; }
+
+  pointer operator->() const { return m_slot; }
+};
+
+#endif // !FLAT_HASHTABLE_HPP
@@ -0,0 +1,53 @@
+#ifndef HASHSET_HPP
+#define HASHSET_HPP
+
+#include <cstddef>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "flat_hashtable.hpp"
+
+/**
+ * Set of keys on the same open addressing engine as flat_hashtable. Each slot is just the key, so a small trivially
+ * copyable key such as an integer costs its own size plus one control byte: no dummy value and its padding, and no
+ * per-entry allocation the way a chained hashtable needs a list node.
+ *
+ * Keys cannot be modified in place, so iterator and const_iterator are the same type.
+ */
+template<typename Key,
+  hasher_for<Key> Hash = hashtable_hash,
+  std::predicate<const Key &, const Key &> KeyEqual = hashtable_equal>
+class hashset : public flat_table<Key, Key, Hash, KeyEqual> {
+  using base = flat_table<Key, Key, Hash, KeyEqual>;
+  using base::try_emplace_impl;
+
+public:
+  using typename base::const_iterator;
+  using typename base::iterator;
+  using base::base;
+
+  /**
+   * Inserts key unless it is already present. Returns an iterator to the key and whether it was inserted.
+   */
+  std::pair<iterator, bool> insert(const Key &key) { return try_emplace_impl(key); }
+
+  std::pair<iterator, bool> insert(Key &&key) { return try_emplace_impl(std::move(key)); }
+
+  /**
+   * Inserts every key of range which is not present yet and returns how many were inserted. If the size of range is
+   * known up front the set makes room for all of it at once instead of growing step by step.
+   */
+  template<std::ranges::input_range R>
+    requires std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<R>>, Key>
+  std::size_t insert_bulk(R &&range) {
+    if constexpr (std::ranges::sized_range<R>) {
+      this->reserve(this->size() + static_cast<std::size_t>(std::ranges::size(range)));
+    }
+    std::size_t inserted = 0;
+    for (auto &&key : range) { inserted += try_emplace_impl(std::forward<decltype(key)>(key)).second; }
+    return inserted;
+  }
+};
+
+#endif // !HASHSET_HPP
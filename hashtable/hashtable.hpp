@@ -1,141 +1,762 @@
 #ifndef HASHTABLE_HPP
 #define HASHTABLE_HPP
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
 #include <concepts>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <iterator>
 #include <list>
 #include <optional>
 #include <ostream>
+#include <ranges>
 #include <stdexcept>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
-#define INITIAL_LOAD 97
+#define INITIAL_LOAD 16
+#define DEFAULT_MAX_LOAD_FACTOR 1.0F
+#define INCREMENTAL_REHASH_STEP 4
+#define FIND_BATCH_SIZE 16
 
+/**
+ * Anything that can be viewed as a run of characters without copying: std::string, std::string_view, string
+ * literals, and string classes exposing c_str() and length() such as simple_string.
+ */
 template<typename T>
-concept Hashable = requires(T t) {
-                     { std::hash<T>{}(t) } -> std::convertible_to<std::size_t>;
-                   };
+concept string_like = std::convertible_to<const T &, std::string_view> || requires(const T &t) {
+  { t.c_str() } -> std::convertible_to<const char *>;
+  { t.length() } -> std::convertible_to<std::size_t>;
+};
 
+template<string_like T> std::string_view as_string_view(const T &s) {
+  if constexpr (std::convertible_to<const T &, std::string_view>) {
+    return std::string_view(s);
+  } else {
+    return std::string_view(s.c_str(), s.length());
+  }
+}
+
+template<typename T>
+concept Hashable = string_like<T> || requires(T t) {
+  { std::hash<T>{}(t) } -> std::convertible_to<std::size_t>;
+};
 
-template<typename Key, typename Value> class hashtableIterator;
+template<typename Hash, typename Key>
+concept hasher_for = requires(const Hash &hash, const Key &key) {
+  { hash(key) } -> std::convertible_to<std::size_t>;
+};
 
 /**
- * Simple Hashtable which only accepts keys of type T which have std::hash<T> specialized,
- * and uses that hash function.
- *
- * Uses external chaining to deal with hash collisions.
+ * Lookups may pass a K instead of a Key when both the hash and the equality are transparent and accept a K, e.g. a
+ * std::string_view or a string literal against std::string keys, which saves building a temporary Key just to look
+ * it up.
  */
-template<Hashable Key, typename Value> class hashtable {
+template<typename K, typename Key, typename Hash, typename KeyEqual>
+concept transparent_key = !std::same_as<std::remove_cvref_t<K>, Key> && requires {
+  typename Hash::is_transparent;
+  typename KeyEqual::is_transparent;
+} && hasher_for<Hash, K> && std::predicate<const KeyEqual &, const Key &, const K &>;
 
-  float loadfactor{};
-  std::vector<std::optional<std::list<std::pair<Key, Value>>>> table;
+template<typename K, typename Key, typename Hash, typename KeyEqual>
+concept lookup_key = std::same_as<std::remove_cvref_t<K>, Key> || transparent_key<K, Key, Hash, KeyEqual>;
 
-public:
-  hashtable() : table(std::vector<std::optional<std::list<std::pair<Key, Value>>>>(INITIAL_LOAD)) {}
+/**
+ * Ranges of (key, value) pairs that can be inserted in bulk, e.g. a std::vector<std::pair<Key, Value>> or another
+ * map.
+ */
+template<typename R, typename Key>
+concept entry_range = std::ranges::input_range<R> && requires(std::ranges::range_reference_t<R> entry) {
+  requires std::same_as<std::remove_cvref_t<decltype(std::get<0>(entry))>, Key>;
+  std::get<1>(entry);
+};
 
-  void insert(Key &&key, Value &&value) {
-    std::size_t idx = std::hash<Key>{}(key) % table.size();
-    if (!table[idx]) {
-      table[idx] = std::list<std::pair<Key, Value>>{ { std::forward<Key>(key), std::forward<Value>(value) } };
-    } else {
-      table[idx]->emplace_back(std::forward<Key>(key), std::forward<Value>(value));
+/**
+ * Hints the cache to start loading addr. Batched lookups issue these for a whole batch before touching any of it.
+ */
+inline void hashtable_prefetch(const void *addr) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(addr);
+#else
+  (void)addr;
+#endif
+}
+
+inline constexpr std::uint64_t hash_secret[] = { 0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL };
+
+/**
+ * Multiplies a and b into 128 bits and folds the halves together, the mixing step of wyhash.
+ */
+inline std::uint64_t hash_mum(std::uint64_t a, std::uint64_t b) {
+  __uint128_t r = static_cast<__uint128_t>(a) * b;
+  return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+}
+
+inline std::uint64_t hash_read64(const char *p) {
+  std::uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline std::uint64_t hash_read32(const char *p) {
+  std::uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+/**
+ * wyhash style hash of len bytes: 16 bytes at a time through hash_mum, with anything up to the last 16 bytes read as
+ * (possibly overlapping) words so there is no byte-by-byte tail loop.
+ */
+inline std::uint64_t hash_bytes(const char *p, std::size_t len) {
+  std::uint64_t seed = hash_secret[0] ^ len;
+  std::uint64_t a = 0;
+  std::uint64_t b = 0;
+  if (len <= 16) {
+    if (len >= 4) {
+      std::size_t mid = (len >> 3) << 2;
+      a = (hash_read32(p) << 32) | hash_read32(p + mid);
+      b = (hash_read32(p + len - 4) << 32) | hash_read32(p + len - 4 - mid);
+    } else if (len > 0) {
+      auto byte = [p](std::size_t i) { return static_cast<std::uint64_t>(static_cast<unsigned char>(p[i])); };
+      a = (byte(0) << 16) | (byte(len >> 1) << 8) | byte(len - 1);
     }
+  } else {
+    std::size_t i = len;
+    for (; i > 16; i -= 16, p += 16) { seed = hash_mum(hash_read64(p) ^ hash_secret[1], hash_read64(p + 8) ^ seed); }
+    a = hash_read64(p + i - 16);
+    b = hash_read64(p + i - 8);
   }
+  return hash_mum(hash_secret[1] ^ len, hash_mum(a ^ hash_secret[1], b ^ seed));
+}
+
+/**
+ * Default hash for the hashtables. Integers and strings go through the wyhash style hash_mum/hash_bytes instead of
+ * std::hash, which in libstdc++ leaves integers unchanged. Every string-like key hashes its characters, so a
+ * std::string key and a string_view or literal with the same characters land in the same bucket. Anything else falls
+ * back to std::hash.
+ */
+struct hashtable_hash {
+  using is_transparent = void;
 
-  Value operator[](Key &&key) {
-    std::size_t idx = std::hash<Key>{}(key) % table.size();
-    auto item = table[idx];
-    if (item) {
-      auto it =
-        std::find_if(item->begin(), item->end(), [&key](const std::pair<Key, Value> &p) { return p.first == key; });
-      if (it == item->end()) { throw std::out_of_range("key does not exist"); }
-      return it->second;
+  template<Hashable T> std::size_t operator()(const T &key) const {
+    if constexpr (string_like<T>) {
+      std::string_view s = as_string_view(key);
+      return static_cast<std::size_t>(hash_bytes(s.data(), s.size()));
+    } else if constexpr (std::integral<T>) {
+      return static_cast<std::size_t>(hash_mum(static_cast<std::uint64_t>(key) ^ hash_secret[0], hash_secret[1]));
+    } else {
+      return std::hash<T>{}(key);
     }
-    throw std::out_of_range("key does not exist");
   }
+};
 
-  void erase(Key &&key) {
-    std::size_t idx = std::hash<Key>{}(key) % table.size();
-    auto &item = table[idx];
-    if (item) {
-      auto it =
-        std::find_if(item->begin(), item->end(), [&key](const std::pair<Key, Value> &p) { return p.first == key; });
-      if (it == item->end()) { throw std::out_of_range("key does not exist"); }
-      item->erase(it);
+/**
+ * Default equality for the hashtables. Any two string-like values compare by their characters; anything else has to
+ * be the same type on both sides.
+ */
+struct hashtable_equal {
+  using is_transparent = void;
+
+  template<typename A, typename B>
+    requires(string_like<A> && string_like<B>) || std::same_as<A, B>
+  bool operator()(const A &a, const B &b) const {
+    if constexpr (string_like<A> && string_like<B>) {
+      return as_string_view(a) == as_string_view(b);
     } else {
-      throw std::out_of_range("key does not exist");
+      return a == b;
     }
   }
+};
 
-  bool contains(Key &&key) {
-    std::size_t idx = std::hash<Key>{}(key) % table.size();
-    auto &item = table[idx];
-    if (item) {
-      return std::find_if(item->begin(), item->end(), [&key](const std::pair<Key, Value> &p) { return p.first == key; })
-             != item->end();
+/**
+ * How evenly a table's entries are spread, as returned by probe_stats(). The probe length of an entry is how many
+ * places a lookup for it has to look at: its position in its chain for hashtable, the number of control byte groups
+ * probed for flat_hashtable.
+ */
+struct hashtable_stats {
+  std::size_t size{};
+  std::size_t bucket_count{};
+  // entries which are not in the first place a lookup for them looks, i.e. collided with another entry
+  std::size_t collisions{};
+  std::size_t max_probe_length{};
+  double mean_probe_length{};
+  // probe_length_histogram[n] is the number of entries with probe length n
+  std::vector<std::size_t> probe_length_histogram;
+
+  void add(std::size_t probe_length, bool collided) {
+    if (probe_length >= probe_length_histogram.size()) { probe_length_histogram.resize(probe_length + 1); }
+    ++probe_length_histogram[probe_length];
+    collisions += collided;
+    max_probe_length = std::max(max_probe_length, probe_length);
+    // size is filled in before any entry is added
+    mean_probe_length += static_cast<double>(probe_length) / static_cast<double>(size);
+  }
+};
+
+/**
+ * Spreads the bits of a hash result so that masking off the low bits gives a usable bucket index. The default hash
+ * does not need it, but a user supplied Hash may be as weak as libstdc++'s std::hash for integers, which would put
+ * sequential keys into sequential buckets.
+ */
+inline std::size_t hashtable_mix(std::size_t hash) {
+  std::uint64_t h = static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ULL;
+  return static_cast<std::size_t>(h ^ (h >> 32));
+}
+
+template<typename Key, typename Value, bool Const> class hashtableIterator;
+
+/**
+ * Simple Hashtable. Keys are hashed with Hash and compared with KeyEqual, which default to hashtable_hash and
+ * hashtable_equal; when both are transparent, lookups also accept any key type they can handle.
+ *
+ * Uses external chaining to deal with hash collisions. The number of buckets is always a power of two and doubles
+ * whenever an insert would take the load factor above max_load_factor().
+ *
+ * With incremental_rehash(true), growing keeps the old bucket array around next to the new one and every
+ * insert, erase and lookup moves INCREMENTAL_REHASH_STEP of the old buckets across, so no single operation pays
+ * for rehashing the whole table. Lookups through a const table cannot migrate anything and search both bucket arrays.
+ * Since migrating moves entries between buckets, in this mode any insert, erase or non-const lookup (find, contains,
+ * at, operator[], find_batch) invalidates every iterator; const lookups leave iterators valid.
+ */
+template<typename Key,
+  typename Value,
+  hasher_for<Key> Hash = hashtable_hash,
+  std::predicate<const Key &, const Key &> KeyEqual = hashtable_equal>
+class hashtable {
+public:
+  using iterator = hashtableIterator<Key, Value, false>;
+  using const_iterator = hashtableIterator<Key, Value, true>;
+
+private:
+  using bucket_type = std::optional<std::list<std::pair<Key, Value>>>;
+  using tabletype = std::vector<bucket_type>;
+
+  float loadfactor{ DEFAULT_MAX_LOAD_FACTOR };
+  std::size_t _size{};
+  tabletype table;
+  // buckets that have not been migrated yet while an incremental rehash is running, empty otherwise
+  tabletype old_table;
+  std::size_t migrate_pos{};
+  bool incremental{};
+  [[no_unique_address]] Hash hasher;
+  [[no_unique_address]] KeyEqual key_equal;
+
+  template<typename K> std::size_t hash(const K &key) const { return hashtable_mix(hasher(key)); }
+
+  template<typename K> std::size_t bucket_index(const K &key) const { return hash(key) & (table.size() - 1); }
+
+  std::size_t min_buckets_for(std::size_t n) const {
+    return static_cast<std::size_t>(std::ceil(static_cast<float>(n) / loadfactor));
+  }
+
+  template<typename List, typename K> auto find_in(List &bucket, const K &key) const {
+    return std::find_if(
+      bucket.begin(), bucket.end(), [this, &key](const std::pair<Key, Value> &p) { return key_equal(p.first, key); });
+  }
+
+  /**
+   * Returns the bucket holding key and its position in that bucket, or a null bucket if key is not in the table.
+   * Self is either hashtable or const hashtable so that both lookups share this.
+   */
+  template<typename Self, typename K> static auto find_entry(Self &self, const K &key) {
+    return find_entry(self, key, self.hash(key));
+  }
+
+  template<typename Self, typename K> static auto find_entry(Self &self, const K &key, std::size_t h) {
+    using result = std::pair<decltype(&self.table[0]), decltype(self.table[0]->begin())>;
+    if (self.rehashing()) {
+      auto &old_bucket = self.old_table[h & (self.old_table.size() - 1)];
+      if (old_bucket) {
+        auto it = self.find_in(*old_bucket, key);
+        if (it != old_bucket->end()) return result{ &old_bucket, it };
+      }
+    }
+    auto &bucket = self.table[h & (self.table.size() - 1)];
+    if (bucket) {
+      auto it = self.find_in(*bucket, key);
+      if (it != bucket->end()) return result{ &bucket, it };
     }
-    return false;
+    return result{ nullptr, {} };
   }
 
-  hashtableIterator<Key, Value> begin() { return hashtableIterator(table, table.begin()); }
+  /**
+   * Looks keys up FIND_BATCH_SIZE at a time in three passes: hash every key of the batch and prefetch its bucket, then
+   * prefetch the first list node of each bucket, and only then walk the chains. The cache misses of a whole batch
+   * overlap instead of being paid one key after another.
+   */
+  template<typename Iterator, typename Self, typename Keys, typename Out>
+  static Out find_batch_impl(Self &self, const Keys &keys, Out out) {
+    using difference = std::ranges::range_difference_t<const Keys>;
+    auto first = std::ranges::begin(keys);
+    auto n = static_cast<std::size_t>(std::ranges::distance(keys));
+    std::array<std::size_t, FIND_BATCH_SIZE> hashes;
+    for (std::size_t start = 0; start < n; start += FIND_BATCH_SIZE) {
+      std::size_t count = std::min<std::size_t>(FIND_BATCH_SIZE, n - start);
+      auto batch = first + static_cast<difference>(start);
+      for (std::size_t i = 0; i < count; ++i) {
+        hashes[i] = self.hash(batch[static_cast<difference>(i)]);
+        hashtable_prefetch(&self.table[hashes[i] & (self.table.size() - 1)]);
+        if (self.rehashing()) { hashtable_prefetch(&self.old_table[hashes[i] & (self.old_table.size() - 1)]); }
+      }
+      for (std::size_t i = 0; i < count; ++i) {
+        const auto &bucket = self.table[hashes[i] & (self.table.size() - 1)];
+        if (bucket && !bucket->empty()) { hashtable_prefetch(&bucket->front()); }
+      }
+      for (std::size_t i = 0; i < count; ++i) {
+        auto [bucket, it] = find_entry(self, batch[static_cast<difference>(i)], hashes[i]);
+        *out++ = bucket ? make_iterator<Iterator>(self, bucket, it) : self.end();
+      }
+    }
+    return out;
+  }
 
-  hashtableIterator<Key, Value> end() { return hashtableIterator(table, table.end(), true); }
-};
+  /**
+   * Builds an iterator pointing at the entry `it` inside bucket, which can be in either bucket array.
+   */
+  template<typename Iterator, typename Self, typename BucketPtr, typename ListIterator>
+  static Iterator make_iterator(Self &self, BucketPtr bucket, ListIterator it) {
+    auto table_end = self.table.data() + self.table.size();
+    if (self.rehashing() && bucket >= self.old_table.data() && bucket < self.old_table.data() + self.old_table.size()) {
+      return Iterator(bucket, self.old_table.data() + self.old_table.size(), self.table.data(), table_end, it);
+    }
+    return Iterator(bucket, table_end, nullptr, nullptr, it);
+  }
 
-template<typename Key, typename Value> class hashtableIterator {
-  using hashiterator = typename std::vector<std::optional<std::list<std::pair<Key, Value>>>>::iterator;
-  using tabletype = std::vector<std::optional<std::list<std::pair<Key, Value>>>>;
-  using listtype = std::list<std::pair<Key, Value>>;
-  using listiterator = typename std::list<std::pair<Key, Value>>::iterator;
-  hashiterator m_table_iter;
-  tabletype m_table;
-  listiterator m_list_iter;
-  listtype m_list;
+  template<typename K, typename... Args> std::pair<iterator, bool> try_emplace_impl(K &&key, Args &&...args) {
+    migrate_buckets();
+    auto [found, it] = find_entry(*this, key);
+    if (found) return { make_iterator<iterator>(*this, found, it), false };
+    if (static_cast<float>(_size + 1) > loadfactor * static_cast<float>(table.size())) { grow(); }
+    auto &bucket = table[bucket_index(key)];
+    if (!bucket) { bucket.emplace(); }
+    bucket->emplace_back(std::piecewise_construct,
+      std::forward_as_tuple(std::forward<K>(key)),
+      std::forward_as_tuple(std::forward<Args>(args)...));
+    ++_size;
+    return { make_iterator<iterator>(*this, &bucket, std::prev(bucket->end())), true };
+  }
+
+  template<typename K> Value &at_impl(const K &key) {
+    migrate_buckets();
+    auto [bucket, it] = find_entry(*this, key);
+    if (!bucket) { throw std::out_of_range("key does not exist"); }
+    return it->second;
+  }
+
+  template<typename K> const Value &at_impl(const K &key) const {
+    auto [bucket, it] = find_entry(*this, key);
+    if (!bucket) { throw std::out_of_range("key does not exist"); }
+    return it->second;
+  }
+
+  template<typename K> void erase_impl(const K &key) {
+    migrate_buckets();
+    auto [bucket, it] = find_entry(*this, key);
+    if (!bucket) { throw std::out_of_range("key does not exist"); }
+    (*bucket)->erase(it);
+    --_size;
+  }
+
+  /**
+   * Splices every node of bucket into its place in table, leaving bucket empty.
+   */
+  void move_bucket(bucket_type &bucket) {
+    if (!bucket) return;
+    while (!bucket->empty()) {
+      auto &target = table[bucket_index(bucket->front().first)];
+      if (!target) { target.emplace(); }
+      target->splice(target->end(), *bucket, bucket->begin());
+    }
+    bucket.reset();
+  }
+
+  /**
+   * Moves up to INCREMENTAL_REHASH_STEP non-empty old buckets into the new table. Empty buckets are cheaper to skip
+   * so more of them are allowed per call, but still a bounded number.
+   */
+  void migrate_buckets() {
+    if (!rehashing()) return;
+    std::size_t moved = 0;
+    std::size_t empty_visits = 0;
+    for (; migrate_pos < old_table.size() && moved < INCREMENTAL_REHASH_STEP; ++migrate_pos) {
+      if (!old_table[migrate_pos]) {
+        if (++empty_visits == INCREMENTAL_REHASH_STEP * 10) break;
+        continue;
+      }
+      move_bucket(old_table[migrate_pos]);
+      ++moved;
+    }
+    if (migrate_pos == old_table.size()) { tabletype().swap(old_table); }
+  }
+
+  void finish_rehash() {
+    if (!rehashing()) return;
+    for (; migrate_pos < old_table.size(); ++migrate_pos) { move_bucket(old_table[migrate_pos]); }
+    tabletype().swap(old_table);
+  }
+
+  void grow() {
+    if (!incremental) {
+      rehash(table.size() * 2);
+      return;
+    }
+    finish_rehash();
+    old_table = tabletype(table.size() * 2);
+    old_table.swap(table);
+    migrate_pos = 0;
+  }
 
 public:
-  using value_type = std::pair<Key, Value>;
+  hashtable() : table(tabletype(INITIAL_LOAD)) {}
+
+  /**
+   * Starts with at least bucket_count buckets, rounded up to a power of two.
+   */
+  explicit hashtable(std::size_t bucket_count, const Hash &hash = Hash(), const KeyEqual &equal = KeyEqual())
+    : table(tabletype(std::bit_ceil(std::max<std::size_t>(bucket_count, 1)))), hasher(hash), key_equal(equal) {}
+
+  Hash hash_function() const { return hasher; }
+
+  KeyEqual key_eq() const { return key_equal; }
 
-  explicit hashtableIterator(tabletype table, hashiterator iter, bool end = false)
-    : m_table(table), m_table_iter(iter) {
-    if (!end) {
-      for (; m_table_iter != m_table.end(); ++m_table_iter) {
-        if (m_table_iter->has_value()) {
-          m_list = m_table_iter->value();
-          m_list_iter = m_list.begin();
-          break;
+  std::size_t size() const { return _size; }
+
+  bool empty() const { return _size == 0; }
+
+  std::size_t bucket_count() const { return table.size(); }
+
+  float load_factor() const { return static_cast<float>(_size) / static_cast<float>(table.size()); }
+
+  float max_load_factor() const { return loadfactor; }
+
+  /**
+   * Sets the load factor past which the table grows, rehashing straight away if it is already above it.
+   */
+  void max_load_factor(float ml) {
+    if (!(ml > 0.0F)) { throw std::invalid_argument("max load factor must be positive"); }
+    loadfactor = ml;
+    if (load_factor() > loadfactor) { rehash(0); }
+  }
+
+  /**
+   * Switches growth between rehashing everything at once and spreading the work over later operations.
+   * Turning it off finishes any rehash that is still in progress.
+   */
+  void incremental_rehash(bool enabled) {
+    incremental = enabled;
+    if (!incremental) { finish_rehash(); }
+  }
+
+  bool incremental_rehash() const { return incremental; }
+
+  /**
+   * True while an incremental rehash still has old buckets left to migrate.
+   */
+  bool rehashing() const { return !old_table.empty(); }
+
+  /**
+   * Moves every entry into a table of at least n buckets, and at least enough buckets to stay under the maximum
+   * load factor. The list nodes are spliced across rather than copied. An explicit rehash always runs to completion,
+   * even in incremental mode.
+   */
+  void rehash(std::size_t n) {
+    finish_rehash();
+    std::size_t new_count = std::bit_ceil(std::max({ n, min_buckets_for(_size), std::size_t{ 1 } }));
+    if (new_count == table.size()) return;
+    tabletype new_table(new_count);
+    table.swap(new_table);
+    for (auto &bucket : new_table) { move_bucket(bucket); }
+  }
+
+  /**
+   * Makes room for n entries without any further rehashing.
+   */
+  void reserve(std::size_t n) {
+    if (min_buckets_for(n) > table.size()) { rehash(min_buckets_for(n)); }
+  }
+
+  /**
+   * Inserts key with a value built from args, unless key is already present in which case nothing is built.
+   * Returns an iterator to the entry for key and whether it was inserted.
+   */
+  template<typename... Args> std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args) {
+    return try_emplace_impl(key, std::forward<Args>(args)...);
+  }
+
+  template<typename... Args> std::pair<iterator, bool> try_emplace(Key &&key, Args &&...args) {
+    return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+  }
+
+  /**
+   * Inserts the pair if key is not present yet, otherwise leaves the existing value alone.
+   */
+  std::pair<iterator, bool> insert(const Key &key, const Value &value) { return try_emplace_impl(key, value); }
+
+  std::pair<iterator, bool> insert(Key &&key, Value &&value) {
+    return try_emplace_impl(std::move(key), std::move(value));
+  }
+
+  /**
+   * Inserts every (key, value) pair of range whose key is not present yet, like insert, and returns how many were
+   * inserted. If the size of range is known up front the table makes room for all of it at once instead of growing
+   * step by step.
+   */
+  template<entry_range<Key> R> std::size_t insert_bulk(R &&range) {
+    if constexpr (std::ranges::sized_range<R>) { reserve(_size + static_cast<std::size_t>(std::ranges::size(range))); }
+    std::size_t inserted = 0;
+    for (auto &&entry : range) {
+      using entry_type = decltype(entry);
+      inserted += try_emplace_impl(std::get<0>(std::forward<entry_type>(entry)),
+        std::get<1>(std::forward<entry_type>(entry)))
+                    .second;
+    }
+    return inserted;
+  }
+
+  /**
+   * Inserts the pair, or assigns value over the existing one if key is already present.
+   */
+  template<typename M> std::pair<iterator, bool> insert_or_assign(const Key &key, M &&value) {
+    auto ret = try_emplace_impl(key, std::forward<M>(value));
+    if (!ret.second) { ret.first->second = std::forward<M>(value); }
+    return ret;
+  }
+
+  template<typename M> std::pair<iterator, bool> insert_or_assign(Key &&key, M &&value) {
+    auto ret = try_emplace_impl(std::move(key), std::forward<M>(value));
+    if (!ret.second) { ret.first->second = std::forward<M>(value); }
+    return ret;
+  }
+
+  /**
+   * Returns a reference to the value stored for key, throwing std::out_of_range if there is none.
+   */
+  Value &at(const Key &key) { return at_impl(key); }
+
+  const Value &at(const Key &key) const { return at_impl(key); }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> Value &at(const K &key) { return at_impl(key); }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> const Value &at(const K &key) const { return at_impl(key); }
+
+  /**
+   * Same as at(). Unlike std::unordered_map this never inserts a default constructed value for a missing key.
+   */
+  Value &operator[](const Key &key) { return at_impl(key); }
+
+  const Value &operator[](const Key &key) const { return at_impl(key); }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> Value &operator[](const K &key) { return at_impl(key); }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> const Value &operator[](const K &key) const {
+    return at_impl(key);
+  }
+
+  iterator find(const Key &key) {
+    migrate_buckets();
+    auto [bucket, it] = find_entry(*this, key);
+    return bucket ? make_iterator<iterator>(*this, bucket, it) : end();
+  }
+
+  const_iterator find(const Key &key) const {
+    auto [bucket, it] = find_entry(*this, key);
+    return bucket ? make_iterator<const_iterator>(*this, bucket, it) : end();
+  }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> iterator find(const K &key) {
+    migrate_buckets();
+    auto [bucket, it] = find_entry(*this, key);
+    return bucket ? make_iterator<iterator>(*this, bucket, it) : end();
+  }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> const_iterator find(const K &key) const {
+    auto [bucket, it] = find_entry(*this, key);
+    return bucket ? make_iterator<const_iterator>(*this, bucket, it) : end();
+  }
+
+  /**
+   * Looks up every key of keys and writes an iterator to its entry, or end() if it is missing, to out. Returns out
+   * past the last iterator written. Faster than calling find per key on tables that do not fit in cache, since the
+   * memory accesses of up to FIND_BATCH_SIZE keys are in flight at once.
+   */
+  template<std::ranges::random_access_range Keys, std::output_iterator<iterator> Out>
+    requires lookup_key<std::ranges::range_value_t<Keys>, Key, Hash, KeyEqual>
+  Out find_batch(const Keys &keys, Out out) {
+    migrate_buckets();
+    return find_batch_impl<iterator>(*this, keys, out);
+  }
+
+  template<std::ranges::random_access_range Keys, std::output_iterator<const_iterator> Out>
+    requires lookup_key<std::ranges::range_value_t<Keys>, Key, Hash, KeyEqual>
+  Out find_batch(const Keys &keys, Out out) const {
+    return find_batch_impl<const_iterator>(*this, keys, out);
+  }
+
+  void erase(const Key &key) { erase_impl(key); }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> void erase(const K &key) { erase_impl(key); }
+
+  bool contains(const Key &key) {
+    migrate_buckets();
+    return find_entry(*this, key).first != nullptr;
+  }
+
+  bool contains(const Key &key) const { return find_entry(*this, key).first != nullptr; }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> bool contains(const K &key) {
+    migrate_buckets();
+    return find_entry(*this, key).first != nullptr;
+  }
+
+  template<transparent_key<Key, Hash, KeyEqual> K> bool contains(const K &key) const {
+    return find_entry(*this, key).first != nullptr;
+  }
+
+  iterator begin() {
+    if (rehashing()) {
+      return iterator(old_table.data(), old_table.data() + old_table.size(), table.data(), table.data() + table.size());
+    }
+    return iterator(table.data(), table.data() + table.size());
+  }
+
+  iterator end() { return iterator(table.data() + table.size(), table.data() + table.size()); }
+
+  const_iterator begin() const {
+    if (rehashing()) {
+      return const_iterator(
+        old_table.data(), old_table.data() + old_table.size(), table.data(), table.data() + table.size());
+    }
+    return const_iterator(table.data(), table.data() + table.size());
+  }
+
+  const_iterator end() const { return const_iterator(table.data() + table.size(), table.data() + table.size()); }
+
+  const_iterator cbegin() const { return begin(); }
+
+  const_iterator cend() const { return end(); }
+
+  /**
+   * Walks every chain to report how the entries are spread over the buckets. Entries still waiting in the old
+   * bucket array during an incremental rehash are counted by their position there.
+   */
+  hashtable_stats probe_stats() const {
+    hashtable_stats stats;
+    stats.size = _size;
+    stats.bucket_count = table.size();
+    for (const tabletype *buckets : { &old_table, &table }) {
+      for (const auto &bucket : *buckets) {
+        if (!bucket) continue;
+        std::size_t length = 0;
+        for (auto it = bucket->begin(); it != bucket->end(); ++it) {
+          ++length;
+          stats.add(length, length > 1);
         }
       }
     }
+    return stats;
+  }
+};
+
+/**
+ * Walks the buckets of a hashtable in place. It only holds pointers into the bucket array and a position in the
+ * current bucket's list, so copying or advancing it never allocates. While an incremental rehash is running the
+ * not yet migrated buckets are visited first, followed by the new bucket array.
+ */
+template<typename Key, typename Value, bool Const> class hashtableIterator {
+  using bucket_type = std::optional<std::list<std::pair<Key, Value>>>;
+  using bucket_ptr = std::conditional_t<Const, const bucket_type *, bucket_type *>;
+  using listiterator = std::conditional_t<Const,
+    typename std::list<std::pair<Key, Value>>::const_iterator,
+    typename std::list<std::pair<Key, Value>>::iterator>;
+  bucket_ptr m_bucket{};
+  bucket_ptr m_bucket_end{};
+  // the bucket array to carry on into once m_bucket_end is reached, if any
+  bucket_ptr m_next{};
+  bucket_ptr m_next_end{};
+  listiterator m_list_iter{};
+
+  friend class hashtableIterator<Key, Value, !Const>;
+
+  bool at_entry() const { return *m_bucket && m_list_iter != (*m_bucket)->end(); }
+
+  void next_bucket() {
+    ++m_bucket;
+    if (m_bucket == m_bucket_end && m_next) {
+      m_bucket = m_next;
+      m_bucket_end = m_next_end;
+      m_next = m_next_end = nullptr;
+    }
+    m_list_iter = m_bucket != m_bucket_end && *m_bucket ? (*m_bucket)->begin() : listiterator{};
+  }
+
+  void skip_empty_buckets() {
+    while (m_bucket != m_bucket_end && !at_entry()) { next_bucket(); }
   }
 
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = std::pair<Key, Value>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+  using reference = std::conditional_t<Const, const value_type &, value_type &>;
+
+  hashtableIterator() = default;
+
+  /**
+   * Starts at the first entry in [first, first_end), then [next, next_end). Passing first == first_end with no
+   * next array gives the end iterator.
+   */
+  hashtableIterator(bucket_ptr first, bucket_ptr first_end, bucket_ptr next = nullptr, bucket_ptr next_end = nullptr)
+    : m_bucket(first), m_bucket_end(first_end), m_next(next), m_next_end(next_end) {
+    if (m_bucket == m_bucket_end) return;
+    if (*m_bucket) { m_list_iter = (*m_bucket)->begin(); }
+    skip_empty_buckets();
+  }
+
+  /**
+   * Points at the entry it inside bucket, which lies in [bucket, bucket_end).
+   */
+  hashtableIterator(bucket_ptr bucket, bucket_ptr bucket_end, bucket_ptr next, bucket_ptr next_end, listiterator it)
+    : m_bucket(bucket), m_bucket_end(bucket_end), m_next(next), m_next_end(next_end), m_list_iter(it) {}
+
+  template<bool OtherConst>
+    requires(Const && !OtherConst)
+  hashtableIterator(const hashtableIterator<Key, Value, OtherConst> &other)
+    : m_bucket(other.m_bucket), m_bucket_end(other.m_bucket_end), m_next(other.m_next), m_next_end(other.m_next_end),
+      m_list_iter(other.m_list_iter) {}
+
   hashtableIterator &operator++() {
-    if (++m_list_iter == m_list.end()) {
-      for (; m_table_iter != m_table.end(); ++m_table_iter) {
-        if (m_table_iter->has_value()) {
-          m_list = m_table_iter->value();
-          m_list_iter = m_list.begin();
-          break;
-        }
-      }
+    ++m_list_iter;
+    if (!at_entry()) {
+      next_bucket();
+      skip_empty_buckets();
     }
     return *this;
   }
 
   hashtableIterator operator++(int) {
-    hashiterator ret = *this;
+    hashtableIterator ret = *this;
     ++*this;
     return ret;
   }
 
-  bool operator==(const hashtableIterator &other) const { return m_table_iter == other.m_table_iter; }
+  bool operator==(const hashtableIterator &other) const {
+    return m_bucket == other.m_bucket && m_list_iter == other.m_list_iter;
+  }
 
   bool operator!=(const hashtableIterator &other) const { return !(*this == other); }
 
-  const value_type &operator*() const { return *m_list_iter; }
+  reference operator*() const { return *m_list_iter; }
 
-  value_type &operator*() { return *m_list_iter; }
+  pointer operator->() const { return &*m_list_iter; }
 };
 
 #endif // !HASHTABLE_HPP
@@ -0,0 +1,500 @@
+#include "concurrent_hashtable.hpp"
+#include "flat_hashtable.hpp"
+#include "hashset.hpp"
+#include "hashtable.hpp"
+#include <algorithm>
+#include <assert.h>
+#include <bit>
+#include <cctype>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+template<typename Table> void test_access() {
+  Table table;
+  for (int i = 0; i < 1000; ++i) { table.insert(int(i), std::to_string(i)); }
+  for (int i = 0; i < 1000; ++i) {
+    assert(table.contains(int(i)));
+    assert(table[int(i)] == std::to_string(i));
+  }
+  assert(!table.contains(1000));
+  assert(!table.contains(-1));
+  try {
+    table[1000];
+    assert(false && "missing key not caught");
+  } catch (const std::out_of_range &) {
+  }
+}
+
+template<typename Table> void test_erase() {
+  Table table;
+  for (int i = 0; i < 1000; ++i) { table.insert(int(i), int(i * 2)); }
+  for (int i = 0; i < 1000; i += 2) { table.erase(int(i)); }
+  for (int i = 0; i < 1000; ++i) { assert(table.contains(int(i)) == (i % 2 == 1)); }
+  for (int i = 0; i < 1000; i += 2) { table.insert(int(i), int(i * 3)); }
+  for (int i = 0; i < 1000; ++i) { assert(table[int(i)] == (i % 2 == 1 ? i * 2 : i * 3)); }
+  try {
+    table.erase(1000);
+    assert(false && "missing key not caught");
+  } catch (const std::out_of_range &) {
+  }
+}
+
+template<typename Table> void test_growth() {
+  Table table;
+  for (int i = 0; i < 10000; ++i) {
+    table.insert(int(i), int(i));
+    assert(table.load_factor() <= table.max_load_factor());
+  }
+  assert(table.size() == 10000);
+  assert(std::has_single_bit(table.bucket_count()));
+  for (int i = 0; i < 10000; ++i) { assert(table[int(i)] == i); }
+
+  table.max_load_factor(0.5F);
+  assert(table.load_factor() <= 0.5F);
+  for (int i = 0; i < 10000; ++i) { assert(table.contains(int(i))); }
+
+  std::size_t buckets = table.bucket_count();
+  table.rehash(buckets * 4);
+  assert(table.bucket_count() == buckets * 4);
+  for (int i = 0; i < 10000; ++i) { assert(table[int(i)] == i); }
+
+  Table reserved;
+  reserved.reserve(5000);
+  buckets = reserved.bucket_count();
+  for (int i = 0; i < 5000; ++i) { reserved.insert(int(i), int(i)); }
+  assert(reserved.bucket_count() == buckets);
+}
+
+/**
+ * Stand-in for simple_string: no std::hash specialization and no conversion to std::string_view, just c_str() and
+ * length().
+ */
+struct c_string {
+  std::string s;
+
+  const char *c_str() const { return s.c_str(); }
+
+  std::size_t length() const { return s.length(); }
+};
+
+template<typename Table> void test_lookup_api() {
+  Table table;
+  std::string one = "one";
+  assert(table.insert(one, 1).second);
+  assert(!table.insert(one, 100).second);
+  assert(table.at(one) == 1);
+  table.insert("two", 2);
+
+  assert(table.contains(std::string_view("one")));
+  assert(table.contains("two"));
+  assert(!table.contains("three"));
+  assert(table.at("two") == 2);
+
+  table["one"] += 10;
+  assert(table.at(std::string_view("one")) == 11);
+  const Table &ctable = table;
+  assert(ctable["one"] == 11);
+
+  auto it = table.find("two");
+  assert(it != table.end() && it->first == "two" && it->second == 2);
+  assert(table.find("three") == table.end());
+  assert(ctable.find(std::string_view("one"))->second == 11);
+
+  auto [emplaced, inserted] = table.try_emplace("three", 3);
+  assert(inserted && emplaced->second == 3);
+  assert(!table.try_emplace("three", 30).second);
+  assert(table.at("three") == 3);
+
+  assert(!table.insert_or_assign("three", 33).second);
+  assert(table.at("three") == 33);
+  assert(table.insert_or_assign("four", 4).second);
+  assert(table.size() == 4);
+
+  table.erase("four");
+  table.erase(std::string_view("three"));
+  assert(table.size() == 2);
+  try {
+    table.at("four");
+    assert(false && "missing key not caught");
+  } catch (const std::out_of_range &) {
+  }
+}
+
+template<template<typename, typename> typename Table> void test_c_string_keys() {
+  Table<c_string, int> table;
+  table.insert(c_string{ "hello" }, 1);
+  assert(table.contains("hello"));
+  assert(table.at(std::string_view("hello")) == 1);
+  assert(!table.contains("world"));
+}
+
+/**
+ * Case-insensitive policies, transparent so that lookups can pass string literals.
+ */
+struct case_insensitive_hash {
+  using is_transparent = void;
+
+  std::size_t operator()(std::string_view s) const {
+    std::string lower(s);
+    for (char &c : lower) { c = static_cast<char>(std::tolower(static_cast<unsigned char>(c))); }
+    return hashtable_hash{}(lower);
+  }
+};
+
+struct case_insensitive_equal {
+  using is_transparent = void;
+
+  bool operator()(std::string_view a, std::string_view b) const {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) {
+      return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+    });
+  }
+};
+
+// sends every key to the same place, so every lookup has to go through KeyEqual
+struct constant_hash {
+  std::size_t operator()(int) const { return 42; }
+};
+
+template<template<typename, typename, typename, typename> typename Table> void test_custom_policies() {
+  Table<std::string, int, case_insensitive_hash, case_insensitive_equal> table;
+  table.insert("Hello", 1);
+  assert(!table.insert("HELLO", 2).second);
+  assert(table.at("hello") == 1);
+  assert(table.contains(std::string_view("hElLo")));
+  table.erase("HeLLo");
+  assert(table.empty());
+
+  Table<int, int, constant_hash, std::equal_to<int>> colliding(64);
+  for (int i = 0; i < 40; ++i) { colliding.insert(int(i), int(i)); }
+  for (int i = 0; i < 40; ++i) { assert(colliding.at(i) == i); }
+  assert(!colliding.contains(40));
+  hashtable_stats stats = colliding.probe_stats();
+  assert(stats.size == 40);
+  assert(stats.collisions == 39);
+}
+
+template<typename Table> void test_probe_stats() {
+  Table table;
+  hashtable_stats stats = table.probe_stats();
+  assert(stats.size == 0 && stats.collisions == 0 && stats.max_probe_length == 0);
+
+  for (int i = 0; i < 10000; ++i) { table.insert(int(i), int(i)); }
+  stats = table.probe_stats();
+  assert(stats.size == 10000);
+  assert(stats.bucket_count == table.bucket_count());
+  std::size_t counted = 0;
+  for (std::size_t n : stats.probe_length_histogram) { counted += n; }
+  assert(counted == 10000);
+  assert(stats.probe_length_histogram[0] == 0);
+  assert(stats.max_probe_length == stats.probe_length_histogram.size() - 1);
+  assert(stats.mean_probe_length >= 1.0 && stats.mean_probe_length <= static_cast<double>(stats.max_probe_length));
+  assert(stats.collisions < stats.size);
+  // sequential integers must not pile up with the default hash
+  assert(stats.max_probe_length <= 8);
+}
+
+template<typename Table> void test_bulk_and_batch() {
+  Table table;
+  std::vector<std::pair<int, int>> entries;
+  for (int i = 0; i < 5000; ++i) { entries.emplace_back(i, i * 2); }
+  assert(table.insert_bulk(entries) == 5000);
+  std::size_t buckets = table.bucket_count();
+  assert(table.size() == 5000);
+  // duplicates are left alone, like insert
+  entries[0].second = -1;
+  assert(table.insert_bulk(std::vector<std::pair<int, int>>(entries.begin(), entries.begin() + 10)) == 0);
+  assert(table.at(0) == 0);
+  assert(table.bucket_count() == buckets);
+
+  std::vector<int> keys;
+  for (int i = -100; i < 5100; i += 3) { keys.push_back(i); }
+  std::vector<typename Table::iterator> found;
+  table.find_batch(keys, std::back_inserter(found));
+  assert(found.size() == keys.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    if (keys[i] < 0 || keys[i] >= 5000) {
+      assert(found[i] == table.end());
+    } else {
+      assert(found[i] != table.end() && found[i]->first == keys[i] && found[i]->second == keys[i] * 2);
+      found[i]->second = 0;
+    }
+  }
+  assert(table.at(2) == 0);
+
+  const Table &ctable = table;
+  std::vector<typename Table::const_iterator> cfound(keys.size());
+  assert(ctable.find_batch(keys, cfound.begin()) == cfound.end());
+  assert(cfound.front() == ctable.end() && cfound[40]->first == keys[40]);
+
+  Table empty;
+  std::vector<typename Table::iterator> none;
+  empty.find_batch(keys, std::back_inserter(none));
+  assert(std::all_of(none.begin(), none.end(), [&empty](auto it) { return it == empty.end(); }));
+}
+
+template<typename Table> void test_batch_transparent() {
+  Table table;
+  table.insert_bulk(std::vector<std::pair<std::string, int>>{ { "one", 1 }, { "two", 2 } });
+  std::vector<std::string_view> keys{ "two", "three", "one" };
+  std::vector<typename Table::iterator> found(3);
+  table.find_batch(keys, found.begin());
+  assert(found[0]->second == 2 && found[1] == table.end() && found[2]->second == 1);
+}
+
+void test_batch_during_rehash() {
+  hashtable<int, int> table;
+  table.incremental_rehash(true);
+  int n = 0;
+  for (; !table.rehashing(); ++n) { table.insert(int(n), int(n)); }
+  std::vector<int> keys(static_cast<std::size_t>(n));
+  for (int i = 0; i < n; ++i) { keys[static_cast<std::size_t>(i)] = i; }
+  std::vector<hashtable<int, int>::const_iterator> found(keys.size());
+  std::as_const(table).find_batch(keys, found.begin());
+  for (int i = 0; i < n; ++i) { assert(found[static_cast<std::size_t>(i)]->second == i); }
+}
+
+void test_hashset() {
+  hashset<int> set;
+  static_assert(std::is_same_v<hashset<int>::iterator, hashset<int>::const_iterator>);
+  static_assert(std::is_same_v<decltype(*set.begin()), const int &>);
+  for (int i = 0; i < 1000; ++i) { assert(set.insert(i * 2).second); }
+  assert(!set.insert(0).second);
+  assert(set.size() == 1000);
+  for (int i = 0; i < 2000; ++i) { assert(set.contains(i) == (i % 2 == 0)); }
+  assert(*set.find(10) == 10);
+  assert(set.find(11) == set.end());
+  for (int i = 0; i < 1000; i += 2) { set.erase(i * 2); }
+  assert(set.size() == 500);
+  long sum = 0;
+  for (int key : set) { sum += key; }
+  assert(sum == 500L * 500 * 2);
+
+  std::vector<int> more(3000);
+  for (int i = 0; i < 3000; ++i) { more[static_cast<std::size_t>(i)] = i; }
+  assert(set.insert_bulk(more) == 2500);
+  assert(set.size() == 3000);
+  std::vector<hashset<int>::iterator> found;
+  set.find_batch(std::vector<int>{ 5, 3000 }, std::back_inserter(found));
+  assert(*found[0] == 5 && found[1] == set.end());
+  // slots hold nothing but the key
+  assert(set.bucket_count() * sizeof(int) < set.size() * 8);
+
+  hashset<std::string> strings;
+  strings.insert("apple");
+  strings.insert(std::string("pear"));
+  assert(strings.contains(std::string_view("apple")));
+  assert(strings.contains("pear"));
+  strings.erase("apple");
+  assert(!strings.contains("apple") && strings.size() == 1);
+  const hashset<std::string> copy(strings);
+  assert(copy.contains("pear"));
+}
+
+void test_incremental_rehash() {
+  hashtable<int, int> table;
+  table.incremental_rehash(true);
+  bool saw_rehash = false;
+  for (int i = 0; i < 10000; ++i) {
+    table.insert(int(i), int(i));
+    saw_rehash |= table.rehashing();
+    if (i % 97 == 0) {
+      // lookups have to find keys on either side of the migration
+      for (int j = 0; j <= i; j += 13) { assert(table.contains(int(j))); }
+    }
+  }
+  assert(saw_rehash);
+  for (int i = 0; i < 10000; i += 2) { table.erase(int(i)); }
+  for (int i = 0; i < 10000; ++i) { assert(table.contains(int(i)) == (i % 2 == 1)); }
+  assert(table.size() == 5000);
+
+  table.incremental_rehash(false);
+  assert(!table.rehashing());
+  for (int i = 1; i < 10000; i += 2) { assert(table[int(i)] == i); }
+
+  // a read-only workload still has to finish the migration
+  hashtable<int, int> reads;
+  reads.incremental_rehash(true);
+  int n = 0;
+  for (; !reads.rehashing(); ++n) { reads.insert(int(n), int(n)); }
+  for (int i = 0; reads.rehashing(); i = (i + 1) % n) { assert(reads.contains(i)); }
+  for (int i = 0; i < n; ++i) { assert(reads.contains(i)); }
+}
+
+void test_flat_churn() {
+  // repeated insert/erase cycles leave tombstones behind which must not stop lookups from terminating
+  flat_hashtable<int, int> table;
+  for (int round = 0; round < 50; ++round) {
+    for (int i = 0; i < 100; ++i) { table.insert(round * 100 + i, int(i)); }
+    for (int i = 0; i < 100; ++i) { table.erase(round * 100 + i); }
+  }
+  assert(table.empty());
+  assert(!table.contains(42));
+  assert(table.bucket_count() <= 256);
+}
+
+void test_flat_matches_reference() {
+  // random inserts and erases over a small key space exercise tombstone reuse and probes that wrap around the end
+  flat_hashtable<int, int> table;
+  std::unordered_map<int, int> reference;
+  std::mt19937 rng(7);
+  for (int i = 0; i < 200000; ++i) {
+    int key = static_cast<int>(rng() % 3000);
+    if (rng() % 3 == 0 && reference.contains(key)) {
+      table.erase(key);
+      reference.erase(key);
+    } else {
+      table.insert_or_assign(key, i);
+      reference[key] = i;
+    }
+  }
+  assert(table.size() == reference.size());
+  for (int key = 0; key < 3000; ++key) {
+    assert(table.contains(key) == reference.contains(key));
+    if (reference.contains(key)) { assert(table.at(key) == reference.at(key)); }
+  }
+  std::size_t count = 0;
+  for (const auto &[key, value] : table) {
+    assert(reference.at(key) == value);
+    ++count;
+  }
+  assert(count == reference.size());
+}
+
+template<typename Table> void test_iterator() {
+  static_assert(std::forward_iterator<typename Table::iterator>);
+  static_assert(std::forward_iterator<typename Table::const_iterator>);
+  Table table;
+  for (int i = 0; i < 500; ++i) { table.insert(int(i), int(i)); }
+  long sum = 0;
+  std::size_t count = 0;
+  for (auto &[key, value] : table) {
+    assert(key == value);
+    value *= 2;
+    sum += key;
+    ++count;
+  }
+  assert(count == 500);
+  assert(sum == 499L * 500 / 2);
+  const Table copy(table);
+  for (const auto &[key, value] : copy) { assert(value == key * 2); }
+  typename Table::const_iterator it = table.begin();
+  assert(it == table.cbegin());
+  Table empty;
+  assert(empty.begin() == empty.end());
+}
+
+void test_iterator_during_rehash() {
+  hashtable<int, int> table;
+  table.incremental_rehash(true);
+  int i = 0;
+  for (; !table.rehashing() || i % 2 == 1; ++i) { table.insert(int(i), int(i)); }
+  assert(table.rehashing());
+  std::vector<bool> seen(static_cast<std::size_t>(i));
+  for (const auto &[key, value] : table) {
+    assert(!seen[static_cast<std::size_t>(key)]);
+    seen[static_cast<std::size_t>(key)] = true;
+  }
+  assert(std::all_of(seen.begin(), seen.end(), [](bool b) { return b; }));
+
+  // const iteration cannot migrate either, so it has to walk the old buckets too
+  const hashtable<int, int> &ctable = table;
+  assert(ctable.rehashing());
+  std::size_t count = 0;
+  for (auto it = ctable.begin(); it != ctable.end(); ++it) { ++count; }
+  assert(count == table.size());
+
+  // const lookups leave the migration, and with it any iterator, alone
+  auto it = table.begin();
+  for (int j = 0; j < i; ++j) { assert(ctable.contains(j)); }
+  assert(table.rehashing());
+  count = 0;
+  for (; it != table.end(); ++it) { ++count; }
+  assert(count == table.size());
+  // non-const lookups migrate, so iterators have to be fetched again afterwards
+  for (int j = 0; table.rehashing(); j = (j + 1) % i) { assert(table.contains(j)); }
+  count = static_cast<std::size_t>(std::distance(table.begin(), table.end()));
+  assert(count == table.size());
+}
+
+void test_concurrent() {
+  concurrent_hashtable<int, int> table;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&table, t] {
+      for (int i = 0; i < 2000; ++i) {
+        int key = t * 2000 + i;
+        assert(table.insert(key, key));
+        assert(table.find(key) == key);
+        if (i % 2 == 0) { assert(table.erase(key)); }
+        assert(table.contains(key) == (i % 2 == 1));
+      }
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+  assert(table.size() == 8000);
+  assert(!table.erase(0));
+  assert(!table.find(0));
+
+  std::size_t seen = 0;
+  table.for_each_shard([&seen](const concurrent_hashtable<int, int>::table_type &shard) {
+    for (const auto &[key, value] : shard) {
+      assert(key == value && key % 2 == 1);
+      ++seen;
+    }
+  });
+  assert(seen == 8000);
+}
+
+int main(void) {
+  std::cout << "Starting tests...\n";
+  test_access<hashtable<int, std::string>>();
+  test_access<flat_hashtable<int, std::string>>();
+  std::cout << "test access passed\n";
+  test_erase<hashtable<int, int>>();
+  test_erase<flat_hashtable<int, int>>();
+  std::cout << "test erase passed\n";
+  test_growth<hashtable<int, int>>();
+  test_growth<flat_hashtable<int, int>>();
+  std::cout << "test growth passed\n";
+  test_lookup_api<hashtable<std::string, int>>();
+  test_lookup_api<flat_hashtable<std::string, int>>();
+  test_c_string_keys<hashtable>();
+  test_c_string_keys<flat_hashtable>();
+  std::cout << "test lookup api passed\n";
+  test_custom_policies<hashtable>();
+  test_custom_policies<flat_hashtable>();
+  test_probe_stats<hashtable<int, int>>();
+  test_probe_stats<flat_hashtable<int, int>>();
+  std::cout << "test hash policies passed\n";
+  test_bulk_and_batch<hashtable<int, int>>();
+  test_bulk_and_batch<flat_hashtable<int, int>>();
+  test_batch_transparent<hashtable<std::string, int>>();
+  test_batch_transparent<flat_hashtable<std::string, int>>();
+  test_batch_during_rehash();
+  std::cout << "test bulk and batch passed\n";
+  test_hashset();
+  std::cout << "test hashset passed\n";
+  test_incremental_rehash();
+  std::cout << "test incremental rehash passed\n";
+  test_flat_churn();
+  std::cout << "test flat churn passed\n";
+  test_flat_matches_reference();
+  std::cout << "test flat matches reference passed\n";
+  test_iterator<hashtable<int, int>>();
+  test_iterator<flat_hashtable<int, int>>();
+  test_iterator_during_rehash();
+  std::cout << "test iterator passed\n";
+  test_concurrent();
+  std::cout << "test concurrent passed\n";
+  std::cout << "All Tests Passed\n";
+}
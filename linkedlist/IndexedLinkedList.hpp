@@ -0,0 +1,642 @@
+#ifndef INDEXED_LINKED_LIST_HPP
+#define INDEXED_LINKED_LIST_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// the most levels a node can be linked into. With a quarter of the nodes on
+// each level going on to the next, this is plenty for any list that fits in
+// memory
+#define INDEXED_MAX_HEIGHT 16
+
+template <typename T> struct IndexedNode;
+
+// a node's links on one level
+template <typename T> struct IndexedLink {
+  IndexedNode<T> *next = nullptr;
+  IndexedNode<T> *prev = nullptr;
+  // how many positions further on next is, if there is a next
+  std::size_t width = 0;
+};
+
+// an element followed by its links on levels [0, height)
+template <typename T>
+struct alignas(std::max(alignof(T), alignof(IndexedLink<T>))) IndexedNode {
+  T data;
+  std::uint32_t height;
+
+  template <typename... Args>
+  IndexedNode(std::uint32_t _height, Args &&...args)
+      : data(std::forward<Args>(args)...), height(_height) {}
+
+  IndexedLink<T> &link(std::uint32_t level) {
+    return std::launder(reinterpret_cast<IndexedLink<T> *>(
+        reinterpret_cast<std::byte *>(this) + sizeof(IndexedNode)))[level];
+  }
+};
+
+template <typename T> class IndexedLinkedListIterator;
+template <typename T> class NodePoolAllocator;
+
+template <typename Allocator>
+inline constexpr bool is_node_pool_allocator = false;
+
+template <typename T>
+inline constexpr bool is_node_pool_allocator<NodePoolAllocator<T>> = true;
+
+// a LinkedList that also finds, inserts and removes elements by position in
+// O(log n) expected time, as an indexable skip list. Every node is on level 0,
+// the doubly linked list of all elements, and each node on a level is also on
+// the next one up with probability 1/4. A link records how many positions it
+// skips, so a lookup walks each level only while that does not overshoot.
+//
+// Pushes and pops at either end stay O(1) expected: they only touch the
+// levels of the node being linked or unlinked. For that the list keeps the
+// first and last node of every level with their keys, a key being a position
+// plus base, and pushing or popping on the left moves base instead of the
+// keys of every level's first node.
+//
+// Iterators refer back to the list to step back from end(), so moving a list
+// invalidates its iterators.
+//
+// A node takes a different number of units depending on its height, which a
+// NodePool, handing out blocks of one size, cannot serve.
+template <typename T, typename Allocator = std::allocator<T>>
+class IndexedLinkedList {
+  static_assert(!is_node_pool_allocator<Allocator>,
+                "IndexedLinkedList nodes vary in size, use another allocator");
+
+  using node = IndexedNode<T>;
+  using link = IndexedLink<T>;
+
+  // nodes and their links are allocated together in units of this
+  struct alignas(node) unit {
+    std::byte bytes[alignof(node)];
+  };
+  using unit_allocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<unit>;
+  using unit_traits = std::allocator_traits<unit_allocator>;
+
+  [[no_unique_address]] unit_allocator alloc;
+  node *heads[INDEXED_MAX_HEIGHT] = {};
+  node *tails[INDEXED_MAX_HEIGHT] = {};
+  std::size_t head_key[INDEXED_MAX_HEIGHT] = {};
+  std::size_t tail_key[INDEXED_MAX_HEIGHT] = {};
+  // keys wrap around, only their differences matter
+  std::size_t base = 0;
+  std::size_t _size = 0;
+  // the levels any node has been on
+  std::uint32_t levels = 0;
+  std::uint64_t rng = 0x9e3779b97f4a7c15;
+
+  static std::size_t units(std::uint32_t height) {
+    return (sizeof(node) + height * sizeof(link) + sizeof(unit) - 1) /
+           sizeof(unit);
+  }
+
+  std::uint32_t random_height() {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    std::uint64_t bits = rng;
+    std::uint32_t height = 1;
+    while (height < INDEXED_MAX_HEIGHT && (bits & 3) == 0) {
+      height++;
+      bits >>= 2;
+    }
+    return height;
+  }
+
+  template <typename... Args> node *create_node(Args &&...args) {
+    std::uint32_t height = random_height();
+    unit *mem = unit_traits::allocate(alloc, units(height));
+    node *n;
+    try {
+      n = ::new (mem) node(height, std::forward<Args>(args)...);
+    } catch (...) {
+      unit_traits::deallocate(alloc, mem, units(height));
+      throw;
+    }
+    for (std::uint32_t level = 0; level < height; ++level)
+      ::new (&n->link(level)) link;
+    levels = std::max(levels, height);
+    return n;
+  }
+
+  void destroy_node(node *n) {
+    std::size_t count = units(n->height);
+    n->~node();
+    unit_traits::deallocate(alloc, reinterpret_cast<unit *>(n), count);
+  }
+
+  // the last node on every level before pos, or null for none, with its
+  // position
+  struct search_path {
+    node *pred[INDEXED_MAX_HEIGHT];
+    std::size_t pos[INDEXED_MAX_HEIGHT];
+  };
+
+  void search(std::size_t pos, search_path &path) const {
+    node *curr = nullptr;
+    std::size_t curr_pos = 0;
+    for (std::uint32_t level = levels; level-- > 0;) {
+      while (true) {
+        node *next = curr ? curr->link(level).next : heads[level];
+        if (!next)
+          break;
+        std::size_t next_pos = curr ? curr_pos + curr->link(level).width
+                                    : head_key[level] - base;
+        if (next_pos >= pos)
+          break;
+        curr = next;
+        curr_pos = next_pos;
+      }
+      path.pred[level] = curr;
+      path.pos[level] = curr_pos;
+    }
+  }
+
+  node *node_at(std::size_t pos) const {
+    if (pos == _size - 1)
+      return tails[0];
+    node *curr = nullptr;
+    std::size_t curr_pos = 0;
+    for (std::uint32_t level = levels; level-- > 0;) {
+      while (true) {
+        node *next = curr ? curr->link(level).next : heads[level];
+        if (!next)
+          break;
+        std::size_t next_pos = curr ? curr_pos + curr->link(level).width
+                                    : head_key[level] - base;
+        if (next_pos > pos)
+          break;
+        curr = next;
+        curr_pos = next_pos;
+      }
+      if (curr_pos == pos && curr)
+        return curr;
+    }
+    return curr;
+  }
+
+  // links n in at pos, strictly between the first and the last element
+  void link_at(node *n, std::size_t pos) {
+    search_path path{};
+    search(pos, path);
+    for (std::uint32_t level = 0; level < levels; ++level) {
+      node *pred = path.pred[level];
+      node *next = pred ? pred->link(level).next : heads[level];
+      if (level >= n->height) {
+        // a link over pos gets one longer
+        if (!next)
+          continue;
+        if (pred)
+          pred->link(level).width++;
+        else
+          head_key[level]++;
+        tail_key[level]++;
+        continue;
+      }
+      link &l = n->link(level);
+      l.prev = pred;
+      l.next = next;
+      if (next) {
+        std::size_t next_pos = pred ? path.pos[level] + pred->link(level).width
+                                    : head_key[level] - base;
+        l.width = next_pos + 1 - pos;
+        next->link(level).prev = n;
+        tail_key[level]++;
+      } else {
+        tails[level] = n;
+        tail_key[level] = base + pos;
+      }
+      if (pred) {
+        pred->link(level).next = n;
+        pred->link(level).width = pos - path.pos[level];
+      } else {
+        heads[level] = n;
+        head_key[level] = base + pos;
+      }
+    }
+    _size++;
+  }
+
+  // unlinks and destroys the node at pos, strictly between the first and the
+  // last element
+  void erase_at(std::size_t pos) {
+    search_path path{};
+    search(pos, path);
+    node *n = path.pred[0] ? path.pred[0]->link(0).next : heads[0];
+    for (std::uint32_t level = 0; level < levels; ++level) {
+      node *pred = path.pred[level];
+      if (level >= n->height) {
+        // a link over pos gets one shorter
+        node *next = pred ? pred->link(level).next : heads[level];
+        if (!next)
+          continue;
+        if (pred)
+          pred->link(level).width--;
+        else
+          head_key[level]--;
+        tail_key[level]--;
+        continue;
+      }
+      link &l = n->link(level);
+      if (l.next) {
+        l.next->link(level).prev = pred;
+        tail_key[level]--;
+      } else if (pred) {
+        tails[level] = pred;
+        tail_key[level] = base + path.pos[level];
+      } else {
+        tails[level] = nullptr;
+      }
+      if (pred) {
+        pred->link(level).next = l.next;
+        if (l.next)
+          pred->link(level).width += l.width - 1;
+      } else {
+        heads[level] = l.next;
+        if (l.next)
+          head_key[level] = base + pos + l.width - 1;
+      }
+    }
+    destroy_node(n);
+    _size--;
+  }
+
+  void link_right(node *n) {
+    std::size_t key = base + _size;
+    for (std::uint32_t level = 0; level < n->height; ++level) {
+      link &l = n->link(level);
+      l.prev = tails[level];
+      if (tails[level]) {
+        tails[level]->link(level).next = n;
+        tails[level]->link(level).width = key - tail_key[level];
+      } else {
+        heads[level] = n;
+        head_key[level] = key;
+      }
+      tails[level] = n;
+      tail_key[level] = key;
+    }
+    _size++;
+  }
+
+  void link_left(node *n) {
+    std::size_t key = --base;
+    for (std::uint32_t level = 0; level < n->height; ++level) {
+      link &l = n->link(level);
+      l.next = heads[level];
+      if (heads[level]) {
+        l.width = head_key[level] - key;
+        heads[level]->link(level).prev = n;
+      } else {
+        tails[level] = n;
+        tail_key[level] = key;
+      }
+      heads[level] = n;
+      head_key[level] = key;
+    }
+    _size++;
+  }
+
+  void erase_right() {
+    node *n = tails[0];
+    for (std::uint32_t level = 0; level < n->height; ++level) {
+      node *prev = n->link(level).prev;
+      tails[level] = prev;
+      if (prev) {
+        prev->link(level).next = nullptr;
+        tail_key[level] -= prev->link(level).width;
+      } else {
+        heads[level] = nullptr;
+      }
+    }
+    destroy_node(n);
+    _size--;
+  }
+
+  void erase_left() {
+    node *n = heads[0];
+    for (std::uint32_t level = 0; level < n->height; ++level) {
+      node *next = n->link(level).next;
+      heads[level] = next;
+      if (next) {
+        next->link(level).prev = nullptr;
+        head_key[level] += n->link(level).width;
+      } else {
+        tails[level] = nullptr;
+      }
+    }
+    destroy_node(n);
+    base++;
+    _size--;
+  }
+
+  void append_all(const IndexedLinkedList &other) {
+    for (const T &val : other)
+      push_right(val);
+  }
+
+  void steal(IndexedLinkedList &other) noexcept {
+    std::copy(std::begin(other.heads), std::end(other.heads), heads);
+    std::copy(std::begin(other.tails), std::end(other.tails), tails);
+    std::copy(std::begin(other.head_key), std::end(other.head_key),
+              head_key);
+    std::copy(std::begin(other.tail_key), std::end(other.tail_key), tail_key);
+    base = other.base;
+    _size = other._size;
+    levels = other.levels;
+    other.forget();
+  }
+
+  // leaves the list empty without touching its nodes
+  void forget() {
+    std::fill(std::begin(heads), std::end(heads), nullptr);
+    std::fill(std::begin(tails), std::end(tails), nullptr);
+    base = 0;
+    _size = 0;
+    levels = 0;
+  }
+
+public:
+  using allocator_type = Allocator;
+  using iterator = IndexedLinkedListIterator<T>;
+  using const_iterator = IndexedLinkedListIterator<const T>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  IndexedLinkedList(std::initializer_list<T> l,
+                    const Allocator &a = Allocator())
+      : alloc(a) {
+    for (const T &val : l)
+      push_right(val);
+  }
+
+  IndexedLinkedList() = default;
+
+  explicit IndexedLinkedList(const Allocator &a) : alloc(a) {}
+
+  IndexedLinkedList(const IndexedLinkedList &other)
+      : alloc(unit_traits::select_on_container_copy_construction(
+            other.alloc)) {
+    append_all(other);
+  }
+
+  IndexedLinkedList(const IndexedLinkedList &other, const Allocator &a)
+      : alloc(a) {
+    append_all(other);
+  }
+
+  // the allocator is copied rather than moved, so that other can go on
+  // allocating from it
+  IndexedLinkedList(IndexedLinkedList &&other) noexcept : alloc(other.alloc) {
+    steal(other);
+  }
+
+  ~IndexedLinkedList() { clear(); }
+
+  IndexedLinkedList &operator=(const IndexedLinkedList &other) {
+    if (&other == this)
+      return *this;
+    clear();
+    if constexpr (unit_traits::propagate_on_container_copy_assignment::value)
+      alloc = other.alloc;
+    append_all(other);
+    return *this;
+  }
+
+  IndexedLinkedList &operator=(IndexedLinkedList &&other) {
+    if (&other == this)
+      return *this;
+    clear();
+    if constexpr (unit_traits::propagate_on_container_move_assignment::value) {
+      alloc = other.alloc;
+    } else if (!(alloc == other.alloc)) {
+      for (T &val : other)
+        push_right(std::move(val));
+      other.clear();
+      return *this;
+    }
+    steal(other);
+    return *this;
+  }
+
+  Allocator get_allocator() const { return Allocator(alloc); }
+
+  // destroys every element and node, walking level 0 in a loop
+  void clear() {
+    node *curr = heads[0];
+    forget();
+    while (curr) {
+      node *next = curr->link(0).next;
+      destroy_node(curr);
+      curr = next;
+    }
+  }
+
+  void push_right(const T &data) { link_right(create_node(data)); }
+
+  void push_left(const T &data) { link_left(create_node(data)); }
+
+  T pop_right() {
+    if (empty())
+      throw std::runtime_error("cannot pop from empty list");
+    T ret = std::move(tails[0]->data);
+    erase_right();
+    return ret;
+  }
+
+  T pop_left() {
+    if (empty())
+      throw std::runtime_error("cannot pop from empty list");
+    T ret = std::move(heads[0]->data);
+    erase_left();
+    return ret;
+  }
+
+  // inserts the elements of other after the element at pos
+  void insert(std::size_t pos, IndexedLinkedList other) {
+    for (T &val : other)
+      insert(++pos, std::move(val));
+  }
+
+  void insert(std::size_t pos, T val) {
+    if (pos > _size)
+      return;
+    if (pos == 0)
+      link_left(create_node(std::move(val)));
+    else if (pos == _size)
+      link_right(create_node(std::move(val)));
+    else
+      link_at(create_node(std::move(val)), pos);
+  }
+
+  void remove(std::size_t pos) {
+    if (pos > _size)
+      return;
+    if (pos == _size || pos == _size - 1)
+      pop_right();
+    else if (pos == 0)
+      pop_left();
+    else
+      erase_at(pos);
+  }
+
+  void remove(std::size_t start, std::size_t num_elems) {
+    while (num_elems--)
+      remove(start);
+  }
+
+  void print_rev() {
+    for (auto it = rbegin(); it != rend(); ++it)
+      std::cout << *it << ' ';
+  }
+
+  T first() { return heads[0]->data; }
+
+  T last() { return tails[0]->data; }
+
+  bool empty() const { return _size == 0; }
+
+  IndexedLinkedList operator+(const IndexedLinkedList &other) const {
+    IndexedLinkedList tmp(*this);
+    tmp.append_all(other);
+    return tmp;
+  }
+
+  IndexedLinkedList &operator+=(const IndexedLinkedList &other) {
+    if (&other == this) {
+      IndexedLinkedList copy(other);
+      append_all(copy);
+    } else {
+      append_all(other);
+    }
+    return *this;
+  }
+
+  T &operator[](const std::size_t &idx) {
+    if (idx >= _size) {
+      throw std::invalid_argument("cannot access index " + std::to_string(idx) +
+                                  " for list of size " + std::to_string(_size));
+    }
+    return node_at(idx)->data;
+  }
+
+  const T &operator[](const std::size_t &idx) const {
+    if (idx >= _size) {
+      throw std::invalid_argument("cannot access index " + std::to_string(idx) +
+                                  " for list of size " + std::to_string(_size));
+    }
+    return node_at(idx)->data;
+  }
+
+  bool operator==(const IndexedLinkedList &other) const {
+    return _size == other._size && std::equal(begin(), end(), other.begin());
+  }
+
+  std::size_t size() const { return _size; }
+
+  iterator begin() { return {heads[0], &tails[0]}; }
+  const_iterator begin() const { return {heads[0], &tails[0]}; }
+
+  iterator end() { return {nullptr, &tails[0]}; }
+  const_iterator end() const { return {nullptr, &tails[0]}; }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  const_reverse_iterator crbegin() const { return rbegin(); }
+  const_reverse_iterator crend() const { return rend(); }
+
+  friend std::ostream &operator<<(std::ostream &out,
+                                  const IndexedLinkedList &ll) {
+    out << "[ ";
+    for (auto &i : ll)
+      out << i << ' ';
+    out << ']';
+    return out;
+  }
+};
+
+// walks level 0. It keeps hold of the list's last node, so that the end can
+// be decremented.
+template <typename T> class IndexedLinkedListIterator {
+  using node = IndexedNode<std::remove_const_t<T>>;
+
+  template <typename U> friend class IndexedLinkedListIterator;
+
+  node *curr = nullptr;
+  node *const *tail = nullptr;
+
+public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = std::remove_const_t<T>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T *;
+  using reference = T &;
+
+  IndexedLinkedListIterator() = default;
+
+  IndexedLinkedListIterator(node *n, node *const *_tail)
+      : curr(n), tail(_tail) {}
+
+  template <typename U>
+    requires std::is_same_v<const U, T>
+  IndexedLinkedListIterator(const IndexedLinkedListIterator<U> &other)
+      : curr(other.curr), tail(other.tail) {}
+
+  IndexedLinkedListIterator &operator++() {
+    curr = curr->link(0).next;
+    return *this;
+  }
+
+  IndexedLinkedListIterator operator++(int) {
+    IndexedLinkedListIterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  IndexedLinkedListIterator &operator--() {
+    curr = curr ? curr->link(0).prev : *tail;
+    return *this;
+  }
+
+  IndexedLinkedListIterator operator--(int) {
+    IndexedLinkedListIterator tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  bool operator==(const IndexedLinkedListIterator &other) const {
+    return curr == other.curr;
+  }
+
+  reference operator*() const { return curr->data; }
+
+  pointer operator->() const { return &curr->data; }
+};
+
+#endif // !INDEXED_LINKED_LIST_HPP
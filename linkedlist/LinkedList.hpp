@@ -8,26 +8,118 @@
 #include <memory>
 #include <ostream>
 #include <string>
+#include <utility>
 
 template <typename T> class LinkedListIterator;
 template <typename T> class LinkedListConstIterator;
 
 template <typename T> struct Node {
   T data;
-  std::unique_ptr<Node> next;
-  Node *prev;
+  Node *next = nullptr;
+  Node *prev = nullptr;
 
-  Node(T _data) : data(_data) {}
+  Node(T _data) : data(std::move(_data)) {}
+
+  template <typename... Args>
+  Node(std::in_place_t, Args &&...args) : data(std::forward<Args>(args)...) {}
 };
 
-template <typename T> class LinkedList {
+// Every node is allocated from Allocator, rebound to Node<T>, which may be
+// stateful such as std::pmr::polymorphic_allocator.
+template <typename T, typename Allocator = std::allocator<T>> class LinkedList {
+  using node_allocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<Node<T>>;
+  using node_traits = std::allocator_traits<node_allocator>;
 
-  std::unique_ptr<Node<T>> head;
-  Node<T> *tail;
+  [[no_unique_address]] node_allocator alloc;
+  Node<T> *head = nullptr;
+  Node<T> *tail = nullptr;
   std::size_t _size = 0;
 
+  template <typename... Args> Node<T> *create_node(Args &&...args) {
+    Node<T> *node = node_traits::allocate(alloc, 1);
+    try {
+      node_traits::construct(alloc, node, std::in_place,
+                             std::forward<Args>(args)...);
+    } catch (...) {
+      node_traits::deallocate(alloc, node, 1);
+      throw;
+    }
+    return node;
+  }
+
+  void destroy_node(Node<T> *node) {
+    node_traits::destroy(alloc, node);
+    node_traits::deallocate(alloc, node, 1);
+  }
+
+  // unlinks node from the list and destroys it
+  void erase_node(Node<T> *node) {
+    if (node->prev)
+      node->prev->next = node->next;
+    else
+      head = node->next;
+    if (node->next)
+      node->next->prev = node->prev;
+    else
+      tail = node->prev;
+    destroy_node(node);
+    _size--;
+  }
+
+  // moves the nodes of other, which must come from an equal allocator, in
+  // after curr
+  void link_after(Node<T> *curr, LinkedList &other) {
+    link_before(curr->next, other, other.head, other.tail, other._size);
+  }
+
+  // unlinks the count nodes from first to last from other and links them in
+  // before curr, or at the end if curr is null
+  void link_before(Node<T> *curr, LinkedList &other, Node<T> *first,
+                   Node<T> *last, std::size_t count) {
+    if (first->prev)
+      first->prev->next = last->next;
+    else
+      other.head = last->next;
+    if (last->next)
+      last->next->prev = first->prev;
+    else
+      other.tail = first->prev;
+    other._size -= count;
+
+    Node<T> *prev = curr ? curr->prev : tail;
+    first->prev = prev;
+    last->next = curr;
+    if (prev)
+      prev->next = first;
+    else
+      head = first;
+    if (curr)
+      curr->prev = last;
+    else
+      tail = last;
+    _size += count;
+  }
+
+  // leaves the list empty without touching its nodes
+  void forget() {
+    head = tail = nullptr;
+    _size = 0;
+  }
+
+  Node<T> *node_at(std::size_t pos) const {
+    Node<T> *curr = head;
+    while (pos--) {
+      curr = curr->next;
+    }
+    return curr;
+  }
+
 public:
-  LinkedList(std::initializer_list<T> l) {
+  using allocator_type = Allocator;
+
+  LinkedList(std::initializer_list<T> l, const Allocator &a = Allocator())
+      : alloc(a) {
     for (const T &val : l) {
       push_right(val);
     }
@@ -35,54 +127,126 @@ public:
 
   LinkedList() = default;
 
-  LinkedList(const LinkedList &other) {
+  explicit LinkedList(const Allocator &a) : alloc(a) {}
+
+  LinkedList(const LinkedList &other)
+      : alloc(node_traits::select_on_container_copy_construction(
+            other.alloc)) {
     for (const auto &i : other) {
       push_right(i);
     }
   }
 
-  void push_right(const T &data) {
+  LinkedList(const LinkedList &other, const Allocator &a) : alloc(a) {
+    for (const auto &i : other) {
+      push_right(i);
+    }
+  }
+
+  // takes over the nodes of other. The allocator is copied rather than moved,
+  // so that other can go on allocating from it.
+  LinkedList(LinkedList &&other) noexcept
+      : alloc(other.alloc), head(other.head), tail(other.tail),
+        _size(other._size) {
+    other.forget();
+  }
+
+  ~LinkedList() { clear(); }
+
+  // the copy keeps this list's allocator unless Allocator says to take
+  // other's
+  LinkedList &operator=(const LinkedList &other) {
+    if (&other == this)
+      return *this;
+    clear();
+    if constexpr (node_traits::propagate_on_container_copy_assignment::value)
+      alloc = other.alloc;
+    for (const auto &i : other) {
+      push_right(i);
+    }
+    return *this;
+  }
+
+  // takes over the nodes of other, unless Allocator keeps this list's
+  // allocator and it differs from other's, in which case the elements are
+  // moved over one by one
+  LinkedList &operator=(LinkedList &&other) noexcept(
+      node_traits::propagate_on_container_move_assignment::value ||
+      node_traits::is_always_equal::value) {
+    if (&other == this)
+      return *this;
+    clear();
+    if constexpr (node_traits::propagate_on_container_move_assignment::value) {
+      alloc = other.alloc;
+    } else if (!(alloc == other.alloc)) {
+      for (T &val : other) {
+        push_right(std::move(val));
+      }
+      other.clear();
+      return *this;
+    }
+    head = other.head;
+    tail = other.tail;
+    _size = other._size;
+    other.forget();
+    return *this;
+  }
+
+  Allocator get_allocator() const { return Allocator(alloc); }
+
+  // destroys every element and gives its node back to the allocator, walking
+  // the list in a loop so that no list is too long to destroy
+  void clear() {
+    Node<T> *curr = head;
+    head = tail = nullptr;
+    _size = 0;
+    while (curr) {
+      Node<T> *next = curr->next;
+      destroy_node(curr);
+      curr = next;
+    }
+  }
+
+  void push_right(const T &data) { emplace_right(data); }
+  void push_right(T &&data) { emplace_right(std::move(data)); }
+
+  void push_left(const T &data) { emplace_left(data); }
+  void push_left(T &&data) { emplace_left(std::move(data)); }
+
+  // constructs an element from args in a new node at the right end
+  template <typename... Args> T &emplace_right(Args &&...args) {
+    Node<T> *new_node = create_node(std::forward<Args>(args)...);
     _size++;
-    Node<T> *new_node = new Node(data);
-    if (empty()) {
-      head.reset(new_node);
-      tail = new_node;
-      head->prev = nullptr;
+    new_node->prev = tail;
+    if (tail) {
+      tail->next = new_node;
     } else {
-      tail->next.reset(new_node);
-      tail->next->prev = tail;
-      tail = new_node;
+      head = new_node;
     }
+    tail = new_node;
+    return new_node->data;
   }
 
-  void push_left(const T &data) {
+  // constructs an element from args in a new node at the left end
+  template <typename... Args> T &emplace_left(Args &&...args) {
+    Node<T> *new_node = create_node(std::forward<Args>(args)...);
     _size++;
-    Node<T> *new_node = new Node(data);
-    if (empty()) {
-      head.reset(new_node);
-      tail = new_node;
-      head->prev = nullptr;
-    } else {
+    new_node->next = head;
+    if (head) {
       head->prev = new_node;
-      head->prev->next.reset(new_node);
-      head.swap(head->prev->next);
-      head->prev = nullptr;
+    } else {
+      tail = new_node;
     }
+    head = new_node;
+    return new_node->data;
   }
 
   T pop_right() {
     if (empty()) {
       throw std::runtime_error("cannot pop from empty list");
     }
-    T ret = tail->data;
-    if (_size == 1) {
-      head.reset();
-      _size -= 1;
-      return ret;
-    }
-    tail = tail->prev;
-    tail->next.reset();
-    _size -= 1;
+    T ret = std::move(tail->data);
+    erase_node(tail);
     return ret;
   }
 
@@ -90,27 +254,77 @@ public:
     if (empty()) {
       throw std::runtime_error("cannot pop from empty list");
     }
-    T ret = head->data;
-    if (_size == 1) {
-      head.reset();
-      _size -= 1;
-      return ret;
-    }
-    _size -= 1;
-    head = std::move(head->next);
-    head->prev = nullptr;
+    T ret = std::move(head->data);
+    erase_node(head);
     return ret;
   }
 
-  void insert(std::size_t pos, LinkedList<T> other) {
-    Node<T> *curr = head.get();
-    while (pos--) {
-      curr = curr->next.get();
+  // inserts the elements of other after the element at pos. Their nodes are
+  // taken over when both lists allocate from the same place, and copied
+  // otherwise, so passing an rvalue copies nothing.
+  void insert(std::size_t pos, LinkedList other) {
+    if (other.empty()) {
+      return;
+    }
+    if (alloc == other.alloc) {
+      link_after(node_at(pos), other);
+      return;
     }
-    curr->next->prev = other.tail;
-    curr->next.swap(other.tail->next);
-    curr->next = std::move(other.head);
-    curr->next->prev = curr;
+    LinkedList copy(other, Allocator(alloc));
+    link_after(node_at(pos), copy);
+  }
+
+  // moves every element of other in before pos, leaving other empty. The
+  // nodes are relinked in O(1) when both lists allocate from the same place,
+  // and the elements are moved into new nodes otherwise.
+  void splice(LinkedListConstIterator<T> pos, LinkedList &other) {
+    if (other.empty() || &other == this)
+      return;
+    if (alloc == other.alloc) {
+      link_before(pos.curr, other, other.head, other.tail, other._size);
+      return;
+    }
+    LinkedList moved{Allocator(alloc)};
+    for (T &val : other) {
+      moved.push_right(std::move(val));
+    }
+    other.clear();
+    link_before(pos.curr, moved, moved.head, moved.tail, moved._size);
+  }
+
+  void splice(LinkedListConstIterator<T> pos, LinkedList &&other) {
+    splice(pos, other);
+  }
+
+  // moves the elements [first, last) of other, which may be this list, in
+  // before pos, which must not be among them. Relinking is O(1), counting the
+  // moved elements is linear in their number unless other is this list.
+  void splice(LinkedListConstIterator<T> pos, LinkedList &other,
+              LinkedListConstIterator<T> first,
+              LinkedListConstIterator<T> last) {
+    if (first == last || first == pos)
+      return;
+    Node<T> *back = last.curr ? last.curr->prev : other.tail;
+    if (&other == this) {
+      link_before(pos.curr, *this, first.curr, back, 0);
+      return;
+    }
+    std::size_t count = 1;
+    for (Node<T> *curr = first.curr; curr != back; curr = curr->next) {
+      count++;
+    }
+    if (alloc == other.alloc) {
+      link_before(pos.curr, other, first.curr, back, count);
+      return;
+    }
+    LinkedList moved{Allocator(alloc)};
+    for (Node<T> *curr = first.curr; curr != last.curr;) {
+      Node<T> *next = curr->next;
+      moved.push_right(std::move(curr->data));
+      other.erase_node(curr);
+      curr = next;
+    }
+    link_before(pos.curr, moved, moved.head, moved.tail, moved._size);
   }
 
   void insert(std::size_t pos, T val) {
@@ -118,22 +332,19 @@ public:
       return;
     }
     if (pos == 0) {
-      push_left(val);
+      push_left(std::move(val));
       return;
     }
     if (pos == this->size()) {
-      push_right(val);
+      push_right(std::move(val));
       return;
     }
-    Node<T> *new_node = new Node(val);
-    Node<T> *curr = head.get();
-    while (pos--) {
-      curr = curr->next.get();
-    }
-    curr->prev->next.swap(new_node->next);
-    curr->prev->next.reset(new_node);
+    Node<T> *curr = node_at(pos);
+    Node<T> *new_node = create_node(std::move(val));
     new_node->prev = curr->prev;
-    new_node->next->prev = new_node;
+    new_node->next = curr;
+    curr->prev->next = new_node;
+    curr->prev = new_node;
     _size++;
   }
 
@@ -141,34 +352,20 @@ public:
     if (pos < 0 || pos > this->size()) {
       return;
     }
-    if (pos == 0) {
-      pop_left();
-      return;
-    }
     if (pos == this->size()) {
       pop_right();
       return;
     }
-    Node<T> *curr = head.get();
-    while (pos--) {
-      curr = curr->next.get();
-    }
-    curr->next->prev = curr->prev;
-    curr->prev->next.swap(curr->next);
-    _size--;
+    erase_node(node_at(pos));
   }
 
   void remove(std::size_t start, std::size_t num_elems) {
-    Node<T> *start_ptr = head.get();
-    while (start--) {
-      start_ptr = start_ptr->next.get();
-    }
-    Node<T> *end_ptr = start_ptr->prev;
+    Node<T> *curr = node_at(start);
     while (num_elems--) {
-      end_ptr = end_ptr->next.get();
+      Node<T> *next = curr->next;
+      erase_node(curr);
+      curr = next;
     }
-    end_ptr->next->prev = start_ptr->prev;
-    start_ptr->prev->next.swap(end_ptr->next);
   }
 
   void print_rev() {
@@ -193,10 +390,24 @@ public:
     return tmp;
   }
 
+  LinkedList operator+(LinkedList &&other) const {
+    LinkedList tmp(*this);
+    tmp.splice(tmp.cend(), other);
+    return tmp;
+  }
+
   LinkedList &operator+=(const LinkedList &other) {
-    for (const auto &i : other) {
-      push_right(i);
+    if (other.empty()) {
+      return *this;
     }
+    // copied first, so that a list can be appended to itself
+    LinkedList copy(other, Allocator(alloc));
+    link_before(nullptr, copy, copy.head, copy.tail, copy._size);
+    return *this;
+  }
+
+  LinkedList &operator+=(LinkedList &&other) {
+    splice(cend(), other);
     return *this;
   }
 
@@ -214,9 +425,9 @@ public:
       return curr->data;
     }
     std::size_t curr_idx = idx;
-    Node<T> *curr = head.get();
+    Node<T> *curr = head;
     while (curr_idx--) {
-      curr = curr->next.get();
+      curr = curr->next;
     }
     return curr->data;
   }
@@ -235,9 +446,9 @@ public:
       return curr->data;
     }
     std::size_t curr_idx = idx;
-    Node<T> *curr = head.get();
+    Node<T> *curr = head;
     while (curr_idx--) {
-      curr = curr->next.get();
+      curr = curr->next;
     }
     return curr->data;
   }
@@ -258,23 +469,23 @@ public:
 
   std::size_t size() { return _size; }
 
-  LinkedListIterator<T> begin() { return {head.get()}; }
-  LinkedListConstIterator<T> begin() const { return {head.get()}; }
+  LinkedListIterator<T> begin() { return {head}; }
+  LinkedListConstIterator<T> begin() const { return {head}; }
 
-  LinkedListIterator<T> end() { return {tail->next.get()}; }
-  LinkedListConstIterator<T> end() const { return {tail->next.get()}; }
+  LinkedListIterator<T> end() { return {nullptr}; }
+  LinkedListConstIterator<T> end() const { return {nullptr}; }
 
   LinkedListIterator<T> rbegin() { return {tail}; }
   LinkedListConstIterator<T> rbegin() const { return {tail}; }
 
-  LinkedListIterator<T> rend() { return {head->prev}; }
-  LinkedListConstIterator<T> rend() const { return {head->prev}; }
+  LinkedListIterator<T> rend() { return {nullptr}; }
+  LinkedListConstIterator<T> rend() const { return {nullptr}; }
 
   LinkedListConstIterator<T> rcbegin() const { return {tail}; }
-  LinkedListConstIterator<T> rcend() const { return {head->prev}; }
+  LinkedListConstIterator<T> rcend() const { return {nullptr}; }
 
-  LinkedListConstIterator<T> cbegin() const { return {head.get()}; }
-  LinkedListConstIterator<T> cend() const { return {tail->next.get()}; }
+  LinkedListConstIterator<T> cbegin() const { return {head}; }
+  LinkedListConstIterator<T> cend() const { return {nullptr}; }
 
   friend std::ostream &operator<<(std::ostream &out, const LinkedList &ll) {
     out << "[ ";
@@ -287,6 +498,8 @@ public:
 };
 
 template <typename T> class LinkedListIterator {
+  template <typename U> friend class LinkedListConstIterator;
+
   Node<T> *curr;
 
   using iterator_category = std::bidirectional_iterator_tag;
@@ -296,13 +509,13 @@ public:
   LinkedListIterator(Node<T> *node) : curr(node) {}
 
   LinkedListIterator &operator++() {
-    curr = curr->next.get();
+    curr = curr->next;
     return *this;
   }
 
   LinkedListIterator operator++(int) {
     Node<T> *tmp = curr;
-    curr = curr->next.get();
+    curr = curr->next;
     return {curr};
   }
 
@@ -331,6 +544,8 @@ public:
 };
 
 template <typename T> class LinkedListConstIterator {
+  template <typename U, typename Allocator> friend class LinkedList;
+
   Node<T> *curr;
 
   using iterator_category = std::bidirectional_iterator_tag;
@@ -339,14 +554,17 @@ template <typename T> class LinkedListConstIterator {
 public:
   LinkedListConstIterator(Node<T> *node) : curr(node) {}
 
+  LinkedListConstIterator(const LinkedListIterator<T> &other)
+      : curr(other.curr) {}
+
   LinkedListConstIterator &operator++() {
-    curr = curr->next.get();
+    curr = curr->next;
     return *this;
   }
 
   LinkedListConstIterator operator++(int) {
     Node<T> *tmp = curr;
-    curr = curr->next.get();
+    curr = curr->next;
     return {curr};
   }
 
@@ -0,0 +1,167 @@
+#ifndef NODE_POOL_HPP
+#define NODE_POOL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include "LinkedList.hpp"
+
+// slabs start out with room for this many blocks and double from there
+#define NODE_POOL_FIRST_SLAB 32
+
+// and stop doubling here
+#define NODE_POOL_MAX_SLAB 4096
+
+// hands out blocks of one size carved from large slabs, and keeps the blocks
+// given back on a free list to hand out again before carving more. The size
+// is that of the first block asked for, which for a LinkedList is a node;
+// other sizes go to the global heap. Slabs are only freed with the pool. Not
+// thread safe, the same as the lists using it.
+class NodePool {
+  // a free block holds the next free block
+  struct free_block {
+    free_block *next;
+  };
+
+  // slabs are chained through their first bytes, the blocks follow
+  struct slab {
+    slab *next;
+  };
+
+  static constexpr std::size_t align = alignof(std::max_align_t);
+
+  std::size_t _block_size = 0;
+  std::size_t slab_blocks = NODE_POOL_FIRST_SLAB;
+  free_block *free_list = nullptr;
+  slab *slabs = nullptr;
+  // the uncarved tail of the newest slab
+  std::byte *carve = nullptr;
+  std::byte *carve_end = nullptr;
+  std::size_t _slab_count = 0;
+  std::size_t _in_use = 0;
+
+  static constexpr std::size_t round_up(std::size_t n) {
+    return (n + align - 1) / align * align;
+  }
+
+  // whether a block of the pool's size holds bytes at alignment
+  bool fits(std::size_t bytes, std::size_t alignment) const {
+    return alignment <= align &&
+           round_up(std::max(bytes, sizeof(free_block))) == _block_size;
+  }
+
+  void add_slab() {
+    std::size_t header = round_up(sizeof(slab));
+    std::size_t bytes = header + slab_blocks * _block_size;
+    // operator new already aligns to max_align_t
+    auto *s = static_cast<slab *>(::operator new(bytes));
+    s->next = slabs;
+    slabs = s;
+    carve = reinterpret_cast<std::byte *>(s) + header;
+    carve_end = carve + slab_blocks * _block_size;
+    _slab_count++;
+    slab_blocks = std::min<std::size_t>(slab_blocks * 2, NODE_POOL_MAX_SLAB);
+  }
+
+public:
+  NodePool() = default;
+
+  NodePool(const NodePool &) = delete;
+  NodePool &operator=(const NodePool &) = delete;
+
+  ~NodePool() {
+    while (slabs) {
+      slab *next = slabs->next;
+      ::operator delete(slabs);
+      slabs = next;
+    }
+  }
+
+  void *allocate(std::size_t bytes, std::size_t alignment) {
+    if (_block_size == 0)
+      _block_size = round_up(std::max(bytes, sizeof(free_block)));
+    if (!fits(bytes, alignment))
+      return ::operator new(bytes, std::align_val_t(alignment));
+    _in_use++;
+    if (free_list) {
+      free_block *block = free_list;
+      free_list = block->next;
+      return block;
+    }
+    if (carve == carve_end)
+      add_slab();
+    void *block = carve;
+    carve += _block_size;
+    return block;
+  }
+
+  void deallocate(void *p, std::size_t bytes, std::size_t alignment) {
+    if (!fits(bytes, alignment)) {
+      ::operator delete(p, std::align_val_t(alignment));
+      return;
+    }
+    _in_use--;
+    free_list = ::new (p) free_block{free_list};
+  }
+
+  // the size of the blocks, 0 until the first allocation
+  std::size_t block_size() const { return _block_size; }
+
+  // blocks handed out and not given back yet
+  std::size_t in_use() const { return _in_use; }
+
+  std::size_t slab_count() const { return _slab_count; }
+};
+
+// an allocator drawing single objects from a NodePool and anything else from
+// the global heap. A default constructed allocator makes a pool of its own,
+// and copies share it, so a list's copies and any list constructed with the
+// same allocator recycle each other's nodes, and insert takes nodes over from
+// another list on the same pool instead of copying them.
+template <typename T> class NodePoolAllocator {
+  template <typename U> friend class NodePoolAllocator;
+
+  std::shared_ptr<NodePool> pool;
+
+public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  NodePoolAllocator() : pool(std::make_shared<NodePool>()) {}
+
+  explicit NodePoolAllocator(std::shared_ptr<NodePool> _pool)
+      : pool(std::move(_pool)) {}
+
+  template <typename U>
+  NodePoolAllocator(const NodePoolAllocator<U> &other) : pool(other.pool) {}
+
+  T *allocate(std::size_t n) {
+    if (n == 1)
+      return static_cast<T *>(pool->allocate(sizeof(T), alignof(T)));
+    return static_cast<T *>(
+        ::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+  }
+
+  void deallocate(T *p, std::size_t n) {
+    if (n == 1)
+      pool->deallocate(p, sizeof(T), alignof(T));
+    else
+      ::operator delete(p, std::align_val_t(alignof(T)));
+  }
+
+  const std::shared_ptr<NodePool> &get_pool() const { return pool; }
+
+  template <typename U>
+  bool operator==(const NodePoolAllocator<U> &other) const {
+    return pool == other.pool;
+  }
+};
+
+template <typename T>
+using PooledLinkedList = LinkedList<T, NodePoolAllocator<T>>;
+
+#endif // !NODE_POOL_HPP
@@ -0,0 +1,558 @@
+#ifndef UNROLLED_LINKED_LIST_HPP
+#define UNROLLED_LINKED_LIST_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// the bytes an unrolled node aims for, two cache lines
+#define UNROLLED_NODE_BYTES 128
+
+// as many elements as fit in UNROLLED_NODE_BYTES next to the links and
+// counts, but at least 4
+template <typename T> constexpr std::size_t unrolled_node_capacity() {
+  constexpr std::size_t header =
+      2 * sizeof(void *) + 2 * sizeof(std::uint32_t);
+  if (header + 4 * sizeof(T) >= UNROLLED_NODE_BYTES)
+    return 4;
+  return (UNROLLED_NODE_BYTES - header) / sizeof(T);
+}
+
+// a node of up to N elements, which live in the slots [lo, hi) of elems
+template <typename T, std::size_t N> struct UnrolledNode {
+  UnrolledNode *next = nullptr;
+  UnrolledNode *prev = nullptr;
+  std::uint32_t lo = 0;
+  std::uint32_t hi = 0;
+  alignas(T) std::byte storage[N * sizeof(T)];
+
+  T *elems() { return std::launder(reinterpret_cast<T *>(storage)); }
+  const T *elems() const {
+    return std::launder(reinterpret_cast<const T *>(storage));
+  }
+
+  std::size_t count() const { return hi - lo; }
+};
+
+template <typename T, std::size_t N> class UnrolledLinkedListIterator;
+
+// a doubly linked list whose nodes hold up to N elements each instead of one,
+// so that the links cost a few bytes per node rather than per element and
+// walking the list reads consecutive elements from the same cache lines. It
+// has the interface of LinkedList.
+//
+// Pushes fill the node at that end and start a new one once it is full, with
+// the elements of a node pushed on the left filling it from the back. An
+// insert into a full node splits it in two halves, and a node that falls to a
+// quarter full after a remove takes in the elements of a neighbour if they
+// fit, so nodes stay reasonably full under any mix of edits.
+template <typename T, std::size_t N = unrolled_node_capacity<T>(),
+          typename Allocator = std::allocator<T>>
+class UnrolledLinkedList {
+  static_assert(N >= 2, "an unrolled node needs room for two elements");
+
+  using node = UnrolledNode<T, N>;
+  using node_allocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+  using node_traits = std::allocator_traits<node_allocator>;
+
+  [[no_unique_address]] node_allocator alloc;
+  node *head = nullptr;
+  node *tail = nullptr;
+  std::size_t _size = 0;
+  std::size_t _nodes = 0;
+
+  // an empty node with its window starting at slot
+  node *create_node(std::uint32_t slot) {
+    node *n = node_traits::allocate(alloc, 1);
+    ::new (n) node;
+    n->lo = n->hi = slot;
+    _nodes++;
+    return n;
+  }
+
+  void destroy_node(node *n) {
+    std::destroy(n->elems() + n->lo, n->elems() + n->hi);
+    n->~node();
+    node_traits::deallocate(alloc, n, 1);
+    _nodes--;
+  }
+
+  // links the empty node n in after curr, or at the front if curr is null
+  void link_after(node *curr, node *n) {
+    n->prev = curr;
+    n->next = curr ? curr->next : head;
+    if (n->next)
+      n->next->prev = n;
+    else
+      tail = n;
+    if (curr)
+      curr->next = n;
+    else
+      head = n;
+  }
+
+  void unlink(node *n) {
+    if (n->prev)
+      n->prev->next = n->next;
+    else
+      head = n->next;
+    if (n->next)
+      n->next->prev = n->prev;
+    else
+      tail = n->prev;
+    destroy_node(n);
+  }
+
+  // moves the elements of n to the slots starting at slot of to, which must
+  // not overlap them
+  static void move_elems(node *n, node *to, std::uint32_t slot) {
+    T *src = n->elems();
+    T *dest = to->elems() + slot;
+    for (std::uint32_t i = n->lo; i < n->hi; ++i, ++dest) {
+      ::new (dest) T(std::move(src[i]));
+      src[i].~T();
+    }
+    to->hi = std::max<std::uint32_t>(to->hi, slot + n->count());
+    to->lo = std::min(to->lo, slot);
+    n->hi = n->lo;
+  }
+
+  // the node holding the element at pos and the slot it is in
+  std::pair<node *, std::uint32_t> locate(std::size_t pos) const {
+    if (pos > _size / 2) {
+      std::size_t back = _size - pos;
+      node *curr = tail;
+      while (back > curr->count()) {
+        back -= curr->count();
+        curr = curr->prev;
+      }
+      return {curr, static_cast<std::uint32_t>(curr->hi - back)};
+    }
+    node *curr = head;
+    while (pos >= curr->count()) {
+      pos -= curr->count();
+      curr = curr->next;
+    }
+    return {curr, static_cast<std::uint32_t>(curr->lo + pos)};
+  }
+
+  // moves the upper half of the full node n to a new node after it
+  void split(node *n) {
+    std::uint32_t mid = n->lo + static_cast<std::uint32_t>(n->count() / 2);
+    node *upper = create_node(0);
+    link_after(n, upper);
+    T *src = n->elems();
+    for (std::uint32_t i = mid; i < n->hi; ++i) {
+      ::new (upper->elems() + upper->hi++) T(std::move(src[i]));
+      src[i].~T();
+    }
+    n->hi = mid;
+  }
+
+  // constructs an element from args at slot of n, which must not be full,
+  // shifting the elements on one side of it by one
+  template <typename... Args>
+  void emplace_in(node *n, std::uint32_t slot, Args &&...args) {
+    T *e = n->elems();
+    bool right = n->hi < N && (n->lo == 0 || slot - n->lo >= n->hi - slot);
+    if (right && slot == n->hi) {
+      ::new (e + slot) T(std::forward<Args>(args)...);
+      n->hi++;
+    } else if (!right && slot == n->lo) {
+      ::new (e + slot - 1) T(std::forward<Args>(args)...);
+      n->lo--;
+    } else {
+      T val(std::forward<Args>(args)...);
+      if (right) {
+        ::new (e + n->hi) T(std::move(e[n->hi - 1]));
+        std::move_backward(e + slot, e + n->hi - 1, e + n->hi);
+        n->hi++;
+        e[slot] = std::move(val);
+      } else {
+        ::new (e + n->lo - 1) T(std::move(e[n->lo]));
+        std::move(e + n->lo + 1, e + slot, e + n->lo);
+        n->lo--;
+        e[slot - 1] = std::move(val);
+      }
+    }
+    _size++;
+  }
+
+  // removes the element at slot of n, and then merges n with a neighbour if
+  // it has fallen to a quarter full
+  void erase_in(node *n, std::uint32_t slot) {
+    T *e = n->elems();
+    if (slot - n->lo < n->hi - slot) {
+      std::move_backward(e + n->lo, e + slot, e + slot + 1);
+      e[n->lo++].~T();
+    } else {
+      std::move(e + slot + 1, e + n->hi, e + slot);
+      e[--n->hi].~T();
+    }
+    _size--;
+    if (n->count() == 0) {
+      unlink(n);
+      return;
+    }
+    if (n->count() > N / 4)
+      return;
+    if (n->next && n->count() + n->next->count() <= N)
+      merge(n, n->next);
+    else if (n->prev && n->prev->count() + n->count() <= N)
+      merge(n->prev, n);
+  }
+
+  // moves the elements of right onto the end of left, its predecessor, and
+  // unlinks right
+  void merge(node *left, node *right) {
+    if (left->hi + right->count() > N) {
+      // slide left's elements to the front of its node first
+      T *e = left->elems();
+      std::uint32_t count = static_cast<std::uint32_t>(left->count());
+      for (std::uint32_t i = 0; i < count; ++i) {
+        ::new (e + i) T(std::move(e[left->lo + i]));
+        e[left->lo + i].~T();
+      }
+      left->lo = 0;
+      left->hi = count;
+    }
+    move_elems(right, left, left->hi);
+    unlink(right);
+  }
+
+  void append_all(const UnrolledLinkedList &other) {
+    for (const T &val : other)
+      push_right(val);
+  }
+
+  void steal(UnrolledLinkedList &other) noexcept {
+    head = std::exchange(other.head, nullptr);
+    tail = std::exchange(other.tail, nullptr);
+    _size = std::exchange(other._size, 0);
+    _nodes = std::exchange(other._nodes, 0);
+  }
+
+public:
+  using allocator_type = Allocator;
+  using iterator = UnrolledLinkedListIterator<T, N>;
+  using const_iterator = UnrolledLinkedListIterator<const T, N>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  UnrolledLinkedList(std::initializer_list<T> l,
+                     const Allocator &a = Allocator())
+      : alloc(a) {
+    for (const T &val : l)
+      push_right(val);
+  }
+
+  UnrolledLinkedList() = default;
+
+  explicit UnrolledLinkedList(const Allocator &a) : alloc(a) {}
+
+  UnrolledLinkedList(const UnrolledLinkedList &other)
+      : alloc(node_traits::select_on_container_copy_construction(
+            other.alloc)) {
+    append_all(other);
+  }
+
+  UnrolledLinkedList(const UnrolledLinkedList &other, const Allocator &a)
+      : alloc(a) {
+    append_all(other);
+  }
+
+  // the allocator is copied rather than moved, so that other can go on
+  // allocating from it
+  UnrolledLinkedList(UnrolledLinkedList &&other) noexcept
+      : alloc(other.alloc) {
+    steal(other);
+  }
+
+  ~UnrolledLinkedList() { clear(); }
+
+  UnrolledLinkedList &operator=(const UnrolledLinkedList &other) {
+    if (&other == this)
+      return *this;
+    clear();
+    if constexpr (node_traits::propagate_on_container_copy_assignment::value)
+      alloc = other.alloc;
+    append_all(other);
+    return *this;
+  }
+
+  UnrolledLinkedList &operator=(UnrolledLinkedList &&other) {
+    if (&other == this)
+      return *this;
+    clear();
+    if constexpr (node_traits::propagate_on_container_move_assignment::value) {
+      alloc = other.alloc;
+    } else if (!(alloc == other.alloc)) {
+      for (T &val : other)
+        push_right(std::move(val));
+      other.clear();
+      return *this;
+    }
+    steal(other);
+    return *this;
+  }
+
+  Allocator get_allocator() const { return Allocator(alloc); }
+
+  // destroys every element and node, walking the list in a loop
+  void clear() {
+    node *curr = head;
+    head = tail = nullptr;
+    _size = 0;
+    while (curr) {
+      node *next = curr->next;
+      destroy_node(curr);
+      curr = next;
+    }
+  }
+
+  void push_right(const T &data) {
+    if (!tail || tail->hi == N)
+      link_after(tail, create_node(0));
+    emplace_in(tail, tail->hi, data);
+  }
+
+  void push_left(const T &data) {
+    if (!head || head->lo == 0)
+      link_after(nullptr, create_node(N));
+    emplace_in(head, head->lo, data);
+  }
+
+  T pop_right() {
+    if (empty())
+      throw std::runtime_error("cannot pop from empty list");
+    T ret = std::move(tail->elems()[tail->hi - 1]);
+    if (tail->count() == 1)
+      unlink(tail);
+    else
+      tail->elems()[--tail->hi].~T();
+    _size--;
+    return ret;
+  }
+
+  T pop_left() {
+    if (empty())
+      throw std::runtime_error("cannot pop from empty list");
+    T ret = std::move(head->elems()[head->lo]);
+    if (head->count() == 1)
+      unlink(head);
+    else
+      head->elems()[head->lo++].~T();
+    _size--;
+    return ret;
+  }
+
+  // inserts the elements of other after the element at pos
+  void insert(std::size_t pos, UnrolledLinkedList other) {
+    for (T &val : other)
+      insert(++pos, std::move(val));
+  }
+
+  void insert(std::size_t pos, T val) {
+    if (pos > _size)
+      return;
+    if (pos == _size) {
+      push_right(std::move(val));
+      return;
+    }
+    if (pos == 0) {
+      push_left(std::move(val));
+      return;
+    }
+    auto [n, slot] = locate(pos);
+    if (n->count() == N) {
+      split(n);
+      if (slot >= n->hi) {
+        slot = slot - n->hi + n->next->lo;
+        n = n->next;
+      }
+    }
+    emplace_in(n, slot, std::move(val));
+  }
+
+  void remove(std::size_t pos) {
+    if (pos > _size)
+      return;
+    if (pos == _size) {
+      pop_right();
+      return;
+    }
+    auto [n, slot] = locate(pos);
+    erase_in(n, slot);
+  }
+
+  void remove(std::size_t start, std::size_t num_elems) {
+    while (num_elems--)
+      remove(start);
+  }
+
+  void print_rev() {
+    for (auto it = rbegin(); it != rend(); ++it)
+      std::cout << *it << ' ';
+  }
+
+  T first() { return head->elems()[head->lo]; }
+
+  T last() { return tail->elems()[tail->hi - 1]; }
+
+  bool empty() const { return _size == 0; }
+
+  UnrolledLinkedList operator+(const UnrolledLinkedList &other) const {
+    UnrolledLinkedList tmp(*this);
+    tmp.append_all(other);
+    return tmp;
+  }
+
+  UnrolledLinkedList &operator+=(const UnrolledLinkedList &other) {
+    if (&other == this) {
+      UnrolledLinkedList copy(other);
+      append_all(copy);
+    } else {
+      append_all(other);
+    }
+    return *this;
+  }
+
+  T &operator[](const std::size_t &idx) {
+    if (idx >= _size) {
+      throw std::invalid_argument("cannot access index " + std::to_string(idx) +
+                                  " for list of size " + std::to_string(_size));
+    }
+    auto [n, slot] = locate(idx);
+    return n->elems()[slot];
+  }
+
+  const T &operator[](const std::size_t &idx) const {
+    if (idx >= _size) {
+      throw std::invalid_argument("cannot access index " + std::to_string(idx) +
+                                  " for list of size " + std::to_string(_size));
+    }
+    auto [n, slot] = locate(idx);
+    return n->elems()[slot];
+  }
+
+  bool operator==(const UnrolledLinkedList &other) const {
+    return _size == other._size && std::equal(begin(), end(), other.begin());
+  }
+
+  std::size_t size() const { return _size; }
+
+  // the number of nodes, for measuring how full they are
+  std::size_t node_count() const { return _nodes; }
+
+  iterator begin() { return head ? iterator(head, head->lo) : iterator(); }
+  const_iterator begin() const {
+    return head ? const_iterator(head, head->lo) : const_iterator();
+  }
+
+  iterator end() { return tail ? iterator(tail, tail->hi) : iterator(); }
+  const_iterator end() const {
+    return tail ? const_iterator(tail, tail->hi) : const_iterator();
+  }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  const_reverse_iterator crbegin() const { return rbegin(); }
+  const_reverse_iterator crend() const { return rend(); }
+
+  friend std::ostream &operator<<(std::ostream &out,
+                                  const UnrolledLinkedList &ll) {
+    out << "[ ";
+    for (auto &i : ll)
+      out << i << ' ';
+    out << ']';
+    return out;
+  }
+};
+
+// a slot of a node. The end of a list is the slot past the last element of
+// its tail, so that the end can be decremented.
+template <typename T, std::size_t N> class UnrolledLinkedListIterator {
+  using node = UnrolledNode<std::remove_const_t<T>, N>;
+
+  template <typename U, std::size_t M> friend class UnrolledLinkedListIterator;
+
+  node *curr = nullptr;
+  std::uint32_t slot = 0;
+
+public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = std::remove_const_t<T>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T *;
+  using reference = T &;
+
+  UnrolledLinkedListIterator() = default;
+
+  UnrolledLinkedListIterator(node *n, std::uint32_t s) : curr(n), slot(s) {}
+
+  template <typename U>
+    requires std::is_same_v<const U, T>
+  UnrolledLinkedListIterator(const UnrolledLinkedListIterator<U, N> &other)
+      : curr(other.curr), slot(other.slot) {}
+
+  UnrolledLinkedListIterator &operator++() {
+    if (++slot == curr->hi && curr->next) {
+      curr = curr->next;
+      slot = curr->lo;
+    }
+    return *this;
+  }
+
+  UnrolledLinkedListIterator operator++(int) {
+    UnrolledLinkedListIterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  UnrolledLinkedListIterator &operator--() {
+    if (slot == curr->lo) {
+      curr = curr->prev;
+      slot = curr->hi;
+    }
+    --slot;
+    return *this;
+  }
+
+  UnrolledLinkedListIterator operator--(int) {
+    UnrolledLinkedListIterator tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  bool operator==(const UnrolledLinkedListIterator &other) const {
+    return curr == other.curr && slot == other.slot;
+  }
+
+  reference operator*() const { return curr->elems()[slot]; }
+
+  pointer operator->() const { return curr->elems() + slot; }
+};
+
+#endif // !UNROLLED_LINKED_LIST_HPP
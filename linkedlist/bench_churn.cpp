@@ -0,0 +1,92 @@
+#include "LinkedList.hpp"
+#include "NodePool.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+/**
+ * Churns LinkedLists with pushes and pops and reports the time per operation
+ * and the number of global heap allocations, counted by replacing the global
+ * operator new, for nodes from the global heap and for nodes from a NodePool.
+ * The queue workload keeps n elements and does a push_right and a pop_left per
+ * operation, the burst workload repeatedly grows a list to n elements at both
+ * ends and drains it again.
+ *
+ * usage: ./bench_churn [list length, default 100000] [operations, default
+ *        20000000]
+ */
+
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t n) {
+  ++allocations;
+  if (void *p = std::malloc(n))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+using clock_type = std::chrono::steady_clock;
+
+static volatile long sink;
+
+template <typename F>
+void report(const char *name, const char *workload, std::size_t ops, F f) {
+  std::size_t before = allocations;
+  auto start = clock_type::now();
+  f();
+  double ns = std::chrono::duration<double, std::nano>(clock_type::now() -
+                                                       start)
+                  .count() /
+              static_cast<double>(ops);
+  std::printf("%-12s %-10s %12zu %10.2f ns/op %12zu allocations\n", name,
+              workload, ops, ns, allocations - before);
+}
+
+template <typename List>
+void queue(const char *name, std::size_t n, std::size_t ops) {
+  List list;
+  for (std::size_t i = 0; i < n; ++i)
+    list.push_right(static_cast<long>(i));
+  report(name, "queue", ops, [&] {
+    long sum = 0;
+    for (std::size_t i = 0; i < ops; ++i) {
+      list.push_right(static_cast<long>(i));
+      sum += list.pop_left();
+    }
+    sink = sum;
+  });
+}
+
+template <typename List>
+void burst(const char *name, std::size_t n, std::size_t ops) {
+  List list;
+  std::size_t rounds = ops / (2 * n) > 0 ? ops / (2 * n) : 1;
+  report(name, "burst", rounds * 2 * n, [&] {
+    long sum = 0;
+    for (std::size_t r = 0; r < rounds; ++r) {
+      for (std::size_t i = 0; i < n; i += 2) {
+        list.push_right(static_cast<long>(i));
+        list.push_left(static_cast<long>(i));
+      }
+      while (!list.empty())
+        sum += list.pop_right();
+    }
+    sink = sum;
+  });
+}
+
+int main(int argc, char **argv) {
+  std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  std::size_t ops = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000000;
+
+  std::printf("lists of %zu longs\n", n);
+  queue<LinkedList<long>>("global heap", n, ops);
+  queue<PooledLinkedList<long>>("NodePool", n, ops);
+  burst<LinkedList<long>>("global heap", n, ops);
+  burst<PooledLinkedList<long>>("NodePool", n, ops);
+}
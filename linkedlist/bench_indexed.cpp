@@ -0,0 +1,76 @@
+#include "IndexedLinkedList.hpp"
+#include "LinkedList.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/**
+ * Runs random positional reads, inserts and removes on a LinkedList and an
+ * IndexedLinkedList of n longs, and push_right + pop_left pairs at the ends,
+ * and reports the time per operation. LinkedList walks from the nearer end for
+ * every positional operation, so it only runs a few of them.
+ *
+ * usage: ./bench_indexed [n, default 1000000] [operations, default 1000000]
+ *        [operations for LinkedList, default 2000]
+ */
+
+using clock_type = std::chrono::steady_clock;
+
+static volatile long sink;
+
+template <typename F>
+void report(const char *name, const char *workload, std::size_t ops, F f) {
+  auto start = clock_type::now();
+  f();
+  double ns = std::chrono::duration<double, std::nano>(clock_type::now() -
+                                                       start)
+                  .count() /
+              static_cast<double>(ops);
+  std::printf("%-18s %-14s %10zu %14.1f ns/op\n", name, workload, ops, ns);
+}
+
+template <typename List>
+void run(const char *name, std::size_t n, std::size_t ops) {
+  List list;
+  for (std::size_t i = 0; i < n; ++i)
+    list.push_right(static_cast<long>(i));
+  std::mt19937_64 rng(42);
+  std::vector<std::size_t> positions(ops);
+  for (auto &pos : positions)
+    pos = rng() % n;
+
+  report(name, "list[i]", ops, [&] {
+    long sum = 0;
+    for (std::size_t pos : positions)
+      sum += list[pos];
+    sink = sum;
+  });
+  report(name, "insert", ops, [&] {
+    for (std::size_t pos : positions)
+      list.insert(pos, -1);
+  });
+  report(name, "remove", ops, [&] {
+    for (std::size_t pos : positions)
+      list.remove(pos);
+  });
+  report(name, "push + pop", 10 * n, [&] {
+    long sum = 0;
+    for (std::size_t i = 0; i < 10 * n; ++i) {
+      list.push_right(static_cast<long>(i));
+      sum += list.pop_left();
+    }
+    sink = sum;
+  });
+}
+
+int main(int argc, char **argv) {
+  std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  std::size_t ops = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+  std::size_t slow_ops = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 2000;
+
+  std::printf("lists of %zu longs\n", n);
+  run<IndexedLinkedList<long>>("IndexedLinkedList", n, ops);
+  run<LinkedList<long>>("LinkedList", n, slow_ops);
+}
@@ -0,0 +1,61 @@
+#include "LinkedList.hpp"
+#include "NodePool.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * Builds a LinkedList of n ints, clears it, builds it again and lets it go out
+ * of scope, and reports the time of every step per node, for nodes from the
+ * global heap and from a NodePool. Nodes used to own the next node through a
+ * std::unique_ptr, so destroying a list recursed once per node and overflowed
+ * the stack long before these sizes; clear and the destructor now walk the
+ * list in a loop.
+ *
+ * usage: ./bench_teardown [n, default 50000000]
+ */
+
+using clock_type = std::chrono::steady_clock;
+
+static volatile int sink;
+
+static double ns_per_node(clock_type::time_point start, std::size_t n) {
+  return std::chrono::duration<double, std::nano>(clock_type::now() - start)
+             .count() /
+         static_cast<double>(n);
+}
+
+template <typename List> void run(const char *name, std::size_t n) {
+  double build, clear, rebuild;
+  auto start = clock_type::now();
+  {
+    List list;
+    for (std::size_t i = 0; i < n; ++i)
+      list.push_right(static_cast<int>(i));
+    build = ns_per_node(start, n);
+
+    start = clock_type::now();
+    list.clear();
+    clear = ns_per_node(start, n);
+
+    start = clock_type::now();
+    for (std::size_t i = 0; i < n; ++i)
+      list.push_left(static_cast<int>(i));
+    rebuild = ns_per_node(start, n);
+    sink = list.first();
+    start = clock_type::now();
+  }
+  double destroy = ns_per_node(start, n);
+  std::printf("%-12s %10.2f %10.2f %10.2f %10.2f\n", name, build, clear,
+              rebuild, destroy);
+}
+
+int main(int argc, char **argv) {
+  std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000000;
+
+  std::printf("%zu ints, ns per node\n", n);
+  std::printf("%-12s %10s %10s %10s %10s\n", "nodes", "build", "clear",
+              "rebuild", "destroy");
+  run<LinkedList<int>>("global heap", n);
+  run<PooledLinkedList<int>>("NodePool", n);
+}
@@ -0,0 +1,83 @@
+#include "LinkedList.hpp"
+#include "UnrolledLinkedList.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+#include <vector>
+
+/**
+ * Builds LinkedLists and UnrolledLinkedLists of ints, and reports the heap
+ * bytes they take per element and the time per element to sum one of them
+ * with its iterators. Bytes are counted by replacing the global operator new
+ * and asking malloc for the usable size of every block, which leaves out the
+ * 8 bytes of glibc's own header per block. The lists are built once as a
+ * single list of n elements, so that consecutive nodes tend to be neighbours
+ * in memory, and once as eight lists of n / 8 elements pushed to in turn, so
+ * that they are not.
+ *
+ * usage: ./bench_unrolled [n, default 10000000] [sums, default 10]
+ */
+
+static std::size_t live_bytes = 0;
+
+void *operator new(std::size_t n) {
+  if (void *p = std::malloc(n)) {
+    live_bytes += malloc_usable_size(p);
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+  if (p)
+    live_bytes -= malloc_usable_size(p);
+  std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept { operator delete(p); }
+
+using clock_type = std::chrono::steady_clock;
+
+static volatile long sink;
+
+template <typename List>
+void run(const char *name, std::size_t n, std::size_t sums,
+         std::size_t interleave) {
+  std::size_t before = live_bytes;
+  std::vector<List> lists(interleave);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (List &list : lists)
+      list.push_right(static_cast<int>(i));
+  }
+  double bytes = static_cast<double>(live_bytes - before) /
+                 static_cast<double>(n * interleave);
+
+  auto start = clock_type::now();
+  long sum = 0;
+  for (std::size_t s = 0; s < sums; ++s) {
+    for (int val : lists[0])
+      sum += val;
+  }
+  double ns = std::chrono::duration<double, std::nano>(clock_type::now() -
+                                                       start)
+                  .count() /
+              static_cast<double>(n * sums);
+  sink = sum;
+  std::printf("%-22s %-12s %10.1f bytes/elem %8.2f ns/elem\n", name,
+              interleave == 1 ? "alone" : "interleaved", bytes, ns);
+}
+
+int main(int argc, char **argv) {
+  std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+  std::size_t sums = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+
+  std::printf("%zu ints, %zu per unrolled node\n", n,
+              unrolled_node_capacity<int>());
+  for (std::size_t interleave : {1, 8}) {
+    std::size_t m = n / interleave;
+    run<LinkedList<int>>("LinkedList", m, sums, interleave);
+    run<UnrolledLinkedList<int>>("UnrolledLinkedList", m, sums, interleave);
+  }
+}
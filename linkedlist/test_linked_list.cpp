@@ -1,6 +1,14 @@
 #include "LinkedList.hpp"
+#include "NodePool.hpp"
+#include "IndexedLinkedList.hpp"
+#include "UnrolledLinkedList.hpp"
 #include <assert.h>
+#include <deque>
+#include <memory_resource>
+#include <random>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 void test_access() {
   LinkedList<int> list;
@@ -58,9 +66,403 @@ void test_equality() {
   assert(list3 != list1);
 }
 
+// a memory resource that counts what is allocated from it
+struct counting_resource : std::pmr::memory_resource {
+  std::size_t allocated = 0;
+  std::size_t live = 0;
+
+  void *do_allocate(std::size_t bytes, std::size_t align) override {
+    allocated++;
+    live++;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+
+  void do_deallocate(void *p, std::size_t bytes, std::size_t align) override {
+    live--;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+
+  bool do_is_equal(const memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+};
+
+void test_allocator() {
+  counting_resource resource;
+  {
+    using pmr_list = LinkedList<int, std::pmr::polymorphic_allocator<int>>;
+    pmr_list list(&resource);
+    for (int i = 0; i < 10; ++i) {
+      list.push_right(i);
+    }
+    list.push_left(-1);
+    list.insert(3, 100);
+    assert(resource.allocated == 12 && resource.live == 12);
+    assert(list.pop_left() == -1 && list.pop_right() == 9);
+    list.remove(0);
+    assert(resource.live == 9 && list.size() == 9);
+    assert(list.get_allocator().resource() == &resource);
+
+    // a copy goes to the default resource unless given one
+    pmr_list copy(list);
+    assert(copy == list && copy.get_allocator().resource() != &resource);
+    pmr_list same(list, &resource);
+    assert(same == list && resource.live == 18);
+
+    // inserted elements always end up in nodes from this list's resource
+    list.insert(1, copy);
+    assert(resource.live == 18 + 9 && list.size() == 18);
+    list.insert(0, same);
+    assert(resource.live == 18 + 18 && list.size() == 27);
+    assert(list[0] == 1 && list[1] == 1 && list[10] == 100);
+  }
+  assert(resource.live == 0);
+
+  LinkedList<std::string, std::allocator<std::string>> strings{"a", "b"};
+  strings = LinkedList<std::string>{"c"};
+  assert(strings.size() == 1 && strings.first() == "c");
+}
+
+// an element that counts its copies and live instances
+struct tracked {
+  static inline int copies = 0;
+  static inline int live = 0;
+  int value;
+
+  explicit tracked(int v) : value(v) { live++; }
+  tracked(int a, int b) : value(a + b) { live++; }
+  tracked(const tracked &other) : value(other.value) {
+    copies++;
+    live++;
+  }
+  tracked(tracked &&other) noexcept : value(other.value) { live++; }
+  tracked &operator=(const tracked &other) {
+    value = other.value;
+    copies++;
+    return *this;
+  }
+  tracked &operator=(tracked &&other) noexcept {
+    value = other.value;
+    return *this;
+  }
+  ~tracked() { live--; }
+  bool operator==(const tracked &other) const { return value == other.value; }
+};
+
+// it moved on by n, as the list iterators have no iterator_traits
+template <typename It> It advanced(It it, int n) {
+  while (n--) {
+    ++it;
+  }
+  return it;
+}
+
+void test_move_splice() {
+  static_assert(std::is_nothrow_move_constructible_v<LinkedList<tracked>>);
+  static_assert(std::is_nothrow_move_assignable_v<LinkedList<tracked>>);
+  {
+    LinkedList<tracked> list;
+    list.push_right(tracked(1));
+    list.push_left(tracked(0));
+    assert(list.emplace_right(2, 3).value == 5);
+    list.emplace_left(-1);
+    assert(tracked::copies == 0);
+    assert(list.size() == 4 && list.first().value == -1);
+    tracked popped = list.pop_right();
+    assert(popped.value == 5 && list.size() == 3);
+    tracked::copies = 0;
+
+    // moving a list or its elements copies nothing
+    LinkedList<tracked> moved(std::move(list));
+    assert(moved.size() == 3 && list.empty() && list.size() == 0);
+    list = std::move(moved);
+    assert(list.size() == 3 && moved.empty());
+    LinkedList<tracked> other;
+    for (int i = 10; i < 15; ++i) {
+      other.emplace_right(i);
+    }
+    // splicing relinks nodes, whole lists or ranges
+    list.splice(advanced(list.begin(), 1), other);
+    assert(list.size() == 8 && other.empty());
+    assert(list[0].value == -1 && list[1].value == 10 && list[6].value == 0);
+    other.splice(other.cend(), list, advanced(list.begin(), 1),
+                 advanced(list.begin(), 3));
+    assert(other.size() == 2 && list.size() == 6);
+    assert(other[0].value == 10 && other[1].value == 11);
+    assert(list[1].value == 12);
+    // a range can move within a list
+    list.splice(list.begin(), list, advanced(list.begin(), 4), list.end());
+    assert(list.size() == 6 && list[0].value == 0 && list[1].value == 1);
+    assert(list[2].value == -1 && list[5].value == 14);
+    list.insert(0, std::move(other));
+    assert(list.size() == 8 && list[1].value == 10);
+    list += LinkedList<tracked>{tracked(7)};
+    assert(list.size() == 9 && list.last().value == 7);
+    // one copy out of the initializer_list, one returned by last()
+    assert(tracked::copies == 2);
+    tracked::copies = 0;
+    list += list;
+    assert(list.size() == 18 && list[9].value == 0 && tracked::copies == 9);
+    LinkedList<tracked> empty;
+    list += empty;
+    assert(list.size() == 18 && list.last().value == 7);
+    empty += empty;
+    assert(empty.empty());
+    list.splice(list.cend(), empty);
+    list.splice(list.cbegin(), list, list.cbegin(), list.cbegin());
+    assert(list.size() == 18);
+  }
+  assert(tracked::live == 0);
+
+  // nodes cannot move between lists on different resources, their elements
+  // are moved into new nodes instead
+  counting_resource resource;
+  using pmr_list = LinkedList<int, std::pmr::polymorphic_allocator<int>>;
+  pmr_list list({1, 2, 3}, &resource);
+  pmr_list other{4, 5, 6};
+  list.splice(list.cend(), other);
+  assert(other.empty() && list.size() == 6 && resource.live == 6);
+  pmr_list more{7, 8, 9};
+  list.splice(list.cbegin(), more, advanced(more.cbegin(), 1), more.cend());
+  assert(more.size() == 1 && list.size() == 8 && resource.live == 8);
+  assert(list.first() == 8 && list[2] == 1 && list.last() == 6);
+  pmr_list taken;
+  taken = std::move(list);
+  assert(taken.size() == 8 && list.empty() && resource.live == 0);
+}
+
+void test_pool() {
+  PooledLinkedList<int> list;
+  const NodePool &pool = *list.get_allocator().get_pool();
+  for (int i = 0; i < 100; ++i) {
+    list.push_right(i);
+  }
+  assert(pool.in_use() == 100 && pool.block_size() >= sizeof(Node<int>));
+  std::size_t slabs = pool.slab_count();
+
+  // popped nodes are handed out again before any new slab is carved
+  for (int i = 0; i < 10000; ++i) {
+    list.push_right(list.pop_left());
+  }
+  list.remove(0, 50);
+  for (int i = 0; i < 50; ++i) {
+    list.push_left(i);
+  }
+  assert(pool.in_use() == 100 && pool.slab_count() == slabs);
+  assert(list.size() == 100 && list.first() == 49 && list.last() == 99);
+
+  // copies share the pool, so inserting one takes its nodes over
+  PooledLinkedList<int> copy(list);
+  assert(copy.get_allocator() == list.get_allocator() && pool.in_use() == 200);
+  list.insert(0, copy);
+  assert(list.size() == 200 && pool.in_use() == 300);
+
+  // a list with a pool of its own gets copies of the nodes
+  PooledLinkedList<int> other{1, 2, 3};
+  assert(!(other.get_allocator() == list.get_allocator()));
+  list.insert(0, other);
+  assert(list.size() == 203 && pool.in_use() == 303);
+  assert(list[0] == 49 && list[1] == 1 && list[4] == 49);
+
+  // lists can be given a pool to share
+  auto shared = std::make_shared<NodePool>();
+  NodePoolAllocator<std::string> shared_alloc(shared);
+  PooledLinkedList<std::string> a(shared_alloc);
+  PooledLinkedList<std::string> b({"x", "y"}, shared_alloc);
+  a.push_right("z");
+  assert(shared->in_use() == 3);
+  b.pop_left();
+  a.push_left("w");
+  assert(shared->in_use() == 3 && shared->slab_count() == 1);
+}
+
+void test_clear() {
+  // long enough to overflow the stack if nodes were destroyed recursively
+  const int n = 1000000;
+  {
+    LinkedList<int> list;
+    for (int i = 0; i < n; ++i) {
+      list.push_right(i);
+    }
+    LinkedList<int> copy(list);
+    list.clear();
+    assert(list.empty() && list.size() == 0);
+    assert(list.begin() == list.end());
+    list.push_left(1);
+    assert(list.first() == 1 && list.last() == 1);
+    assert(copy.size() == n);
+  }
+
+  PooledLinkedList<int> pooled;
+  const NodePool &pool = *pooled.get_allocator().get_pool();
+  for (int i = 0; i < n; ++i) {
+    pooled.push_right(i);
+  }
+  std::size_t slabs = pool.slab_count();
+  pooled.clear();
+  assert(pooled.empty() && pool.in_use() == 0);
+  for (int i = 0; i < n; ++i) {
+    pooled.push_left(i);
+  }
+  assert(pool.in_use() == n && pool.slab_count() == slabs);
+  assert(pooled.first() == n - 1 && pooled.last() == 0);
+}
+
+// runs random edits on list and on a std::deque side by side
+template <typename List> void check_edits(List &list, std::size_t ops) {
+  std::deque<std::string> expected(list.begin(), list.end());
+  std::mt19937 rng(7);
+  for (std::size_t i = 0; i < ops; ++i) {
+    std::string val = std::to_string(i);
+    std::size_t pos = expected.empty() ? 0 : rng() % expected.size();
+    switch (rng() % 6) {
+    case 0:
+      list.push_left(val);
+      expected.push_front(val);
+      break;
+    case 1:
+      list.push_right(val);
+      expected.push_back(val);
+      break;
+    case 2:
+      list.insert(pos, val);
+      expected.insert(expected.begin() + pos, val);
+      break;
+    case 3:
+      if (expected.empty())
+        break;
+      list.remove(pos);
+      expected.erase(expected.begin() + pos);
+      break;
+    case 4:
+      if (expected.empty())
+        break;
+      assert(list.pop_left() == expected.front());
+      expected.pop_front();
+      break;
+    case 5:
+      if (expected.empty())
+        break;
+      assert(list.pop_right() == expected.back());
+      expected.pop_back();
+      break;
+    }
+    assert(list.size() == expected.size());
+    if (!expected.empty())
+      assert(list[pos % expected.size()] == expected[pos % expected.size()]);
+  }
+  assert(std::equal(list.begin(), list.end(), expected.begin(),
+                    expected.end()));
+  assert(std::equal(list.rbegin(), list.rend(), expected.rbegin(),
+                    expected.rend()));
+}
+
+void test_unrolled() {
+  UnrolledLinkedList<int> list;
+  for (int i = 0; i < 100; ++i) {
+    list.push_right(i);
+  }
+  for (int i = 0; i < 100; ++i) {
+    list.push_left(-i - 1);
+  }
+  assert(list.size() == 200 && list.first() == -100 && list.last() == 99);
+  assert(list[0] == -100 && list[100] == 0 && list[199] == 99);
+  // pushes at either end leave every node but the end ones full
+  std::size_t per_node = unrolled_node_capacity<int>();
+  assert(list.node_count() <= 200 / per_node + 2);
+  int expected = -100;
+  for (int val : list) {
+    assert(val == expected++);
+  }
+  auto it = list.end();
+  for (int i = 99; i >= -100; --i) {
+    assert(*--it == i);
+  }
+  assert(it == list.begin());
+  try {
+    list[200];
+    assert(false);
+  } catch (std::invalid_argument &) {
+  }
+
+  UnrolledLinkedList<std::string, 4> small{"a", "b", "c", "d", "e"};
+  UnrolledLinkedList<std::string, 4> copy(small);
+  assert(copy == small && small.node_count() == 2);
+  small.insert(1, copy);
+  assert(small.size() == 10 && small[2] == "a" && small[6] == "e");
+  small.remove(0, 4);
+  assert(small.size() == 6 && small.first() == "c" && small.last() == "e");
+  small += small;
+  assert(small.size() == 12 && (small + copy).size() == 17);
+  UnrolledLinkedList<std::string, 4> moved(std::move(small));
+  assert(moved.size() == 12 && small.empty() && small.begin() == small.end());
+  small = std::move(moved);
+  assert(small.size() == 12 && moved.empty());
+  check_edits(small, 20000);
+  // removes merge nodes that have emptied out
+  std::size_t size = small.size();
+  assert(small.node_count() <= 2 * ((size + 3) / 4) + 1);
+  small.clear();
+  assert(small.empty() && small.node_count() == 0);
+
+  UnrolledLinkedList<std::string, 2> pairs;
+  check_edits(pairs, 5000);
+
+  UnrolledLinkedList<std::string, 7, NodePoolAllocator<std::string>> pooled;
+  check_edits(pooled, 5000);
+  assert(pooled.get_allocator().get_pool()->in_use() == pooled.node_count());
+}
+
+void test_indexed() {
+  // IndexedLinkedList refuses a NodePoolAllocator, whose pool cannot serve
+  // nodes of different heights
+  static_assert(is_node_pool_allocator<NodePoolAllocator<std::string>>);
+  static_assert(!is_node_pool_allocator<std::allocator<std::string>>);
+  IndexedLinkedList<int> list;
+  for (int i = 0; i < 1000; ++i) {
+    list.push_right(i);
+    list.push_left(-i - 1);
+  }
+  assert(list.size() == 2000 && list.first() == -1000 && list.last() == 999);
+  for (int i = 0; i < 2000; ++i) {
+    assert(list[i] == i - 1000);
+  }
+  list.insert(1000, 5000);
+  list.remove(500);
+  assert(list[999] == 5000 && list[500] == -499 && list.size() == 2000);
+  auto it = list.end();
+  assert(*--it == 999 && *std::prev(it, 1000) == 5000);
+  try {
+    list[2000];
+    assert(false);
+  } catch (std::invalid_argument &) {
+  }
+
+  IndexedLinkedList<std::string> strings{"a", "b", "c"};
+  IndexedLinkedList<std::string> copy(strings);
+  strings.insert(0, copy);
+  assert(strings.size() == 6 && strings[1] == "a" && strings[4] == "b");
+  strings += strings;
+  assert(strings.size() == 12 && strings + copy != strings);
+  IndexedLinkedList<std::string> moved(std::move(strings));
+  assert(moved.size() == 12 && strings.empty());
+  assert(strings.begin() == strings.end());
+  strings = std::move(moved);
+  check_edits(strings, 20000);
+  strings.clear();
+  assert(strings.empty());
+  check_edits(strings, 20000);
+}
+
 int main(void) {
   test_access();
   test_iterator();
   test_equality();
+  test_allocator();
+  test_move_splice();
+  test_pool();
+  test_clear();
+  test_unrolled();
+  test_indexed();
   std::cout << "All Tests Passed\n";
 }